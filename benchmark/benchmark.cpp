@@ -12,6 +12,13 @@
 // limitations under the License.
 
 #include <benchmark/benchmark.h>
+#include <boost/signals2.hpp>
+
+#include <chrono>
+#include <future>
+#include <span>
+#include <tuple>
+#include <vector>
 
 #include "dispatcher.hpp"
 
@@ -88,6 +95,24 @@ struct Addition {
     using return_t = int;
 };
 
+static void CallAdditionStdFunction(benchmark::State &state)
+{
+    std::function<int(int, int)> function{[](int a, int b) { return a + b; }};
+    bm::DoNotOptimize(function);
+    for (auto _ : state) {
+        bm::DoNotOptimize(function(1, 2));
+    }
+}
+
+static void CallAdditionInplaceFunction(benchmark::State &state)
+{
+    dispatcher::internal::InplaceFunction<int(int, int)> function{[](int a, int b) { return a + b; }};
+    bm::DoNotOptimize(function);
+    for (auto _ : state) {
+        bm::DoNotOptimize(function(1, 2));
+    }
+}
+
 static void CallAdditionFunctionDispatcher(benchmark::State &state)
 {
     dispatcher::attach<Addition>([](int a, int b) { return a + b; });
@@ -96,6 +121,47 @@ static void CallAdditionFunctionDispatcher(benchmark::State &state)
     }
 }
 
+struct StaticAddition {
+    using args_t = std::tuple<int, int>;
+    using return_t = int;
+};
+
+int Add(int a, int b)
+{
+    return a + b;
+}
+
+DISPATCHER_ATTACH_STATIC(StaticAddition, &Add);
+
+static void CallAdditionStaticDispatcher(benchmark::State &state)
+{
+    for (auto _ : state) {
+        bm::DoNotOptimize(dispatcher::call<StaticAddition>(2, 3));
+    }
+}
+
+struct UnattachedAddition {
+    using args_t = std::tuple<int, int>;
+    using return_t = int;
+};
+
+static void CallMissingHandlerThrowing(benchmark::State &state)
+{
+    for (auto _ : state) {
+        try {
+            bm::DoNotOptimize(dispatcher::call<UnattachedAddition>(2, 3));
+        } catch (const dispatcher::NoHandler<UnattachedAddition> &) {
+        }
+    }
+}
+
+static void CallMissingHandlerTryCall(benchmark::State &state)
+{
+    for (auto _ : state) {
+        bm::DoNotOptimize(dispatcher::try_call<UnattachedAddition>(2, 3));
+    }
+}
+
 static void CallManipulateStringDirectly(benchmark::State &state)
 {
     std::vector<Derive *> objects;
@@ -175,13 +241,588 @@ static void CallManipulateStringRefFunctionDispatcher(benchmark::State &state)
     }
 }
 
+struct LatencyNetwork {};
+
+// Time between a post from an external thread and the execution of the task on the event loop
+static void PostLatency(benchmark::State &state)
+{
+    for (auto _ : state) {
+        std::promise<void> executed;
+        dispatcher::post<LatencyNetwork>([&executed] { executed.set_value(); });
+        executed.get_future().wait();
+    }
+}
+
+// Time between waking up a fiber waiting on the event loop from an external thread and its resumption
+static void FiberWakeUpLatency(benchmark::State &state)
+{
+    for (auto _ : state) {
+        state.PauseTiming();
+        boost::fibers::promise<void> wake_up;
+        std::promise<void> waiting;
+        std::promise<void> resumed;
+        dispatcher::post<LatencyNetwork>([&] {
+            auto future = wake_up.get_future();
+            waiting.set_value();
+            future.wait();
+            resumed.set_value();
+        });
+        waiting.get_future().wait();
+        state.ResumeTiming();
+
+        wake_up.set_value();
+        resumed.get_future().wait();
+    }
+}
+
+struct ThroughputEvent {
+    using parameters_t = std::tuple<int>;
+};
+
+// Cost of a publish when the subscribers do not block, dominated by the per-event scheduling overhead
+static void PublishThroughput(benchmark::State &state)
+{
+    std::atomic<int> received{0};
+    auto connection =
+        dispatcher::subscribe<ThroughputEvent, LatencyNetwork>([&received](int value) { received += value; });
+    for (auto _ : state) {
+        received = 0;
+        for (int i = 0; i < state.range(0); i++) {
+            dispatcher::publish<ThroughputEvent, LatencyNetwork>(1);
+        }
+        while (received != state.range(0)) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    connection.disconnect();
+}
+
+struct BoundedThroughputEvent {
+    using parameters_t = std::tuple<int>;
+    static constexpr std::size_t event_queue_bound = 64;
+    static constexpr dispatcher::OverflowPolicy overflow_policy = dispatcher::OverflowPolicy::Block;
+};
+
+// Same as PublishThroughput, the publisher being suspended whenever 64 events are queued. The memory used by the
+// queued events stays bounded whatever the burst size.
+static void PublishBoundedThroughput(benchmark::State &state)
+{
+    std::atomic<int> received{0};
+    auto connection =
+        dispatcher::subscribe<BoundedThroughputEvent, LatencyNetwork>([&received](int value) { received += value; });
+    for (auto _ : state) {
+        received = 0;
+        for (int i = 0; i < state.range(0); i++) {
+            dispatcher::publish<BoundedThroughputEvent, LatencyNetwork>(1);
+        }
+        while (received != state.range(0)) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["high_water_depth"] =
+        dispatcher::get_event_queue_stats<BoundedThroughputEvent, LatencyNetwork>().high_water_depth;
+    connection.disconnect();
+}
+
+struct LatestValueEvent {
+    using parameters_t = std::tuple<int>;
+    static constexpr bool conflate = true;
+};
+
+// Same as PublishThroughput for a state-like event, the subscriber only receiving the values that were not already
+// overwritten when the event loop got to them
+static void PublishLatestThroughput(benchmark::State &state)
+{
+    std::atomic<int> latest{0};
+    std::atomic<int> delivered{0};
+    auto connection = dispatcher::subscribe<LatestValueEvent, LatencyNetwork>([&](int value) {
+        latest = value;
+        ++delivered;
+    });
+    for (auto _ : state) {
+        latest = 0;
+        for (int i = 1; i <= state.range(0); i++) {
+            dispatcher::publish<LatestValueEvent, LatencyNetwork>(i);
+        }
+        while (latest != state.range(0)) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["delivered_per_iteration"] = static_cast<double>(delivered) / state.iterations();
+    connection.disconnect();
+}
+
+// Same events as PublishThroughput, published as one batch
+static void PublishBatchThroughput(benchmark::State &state)
+{
+    std::atomic<int> received{0};
+    auto connection =
+        dispatcher::subscribe<ThroughputEvent, LatencyNetwork>([&received](int value) { received += value; });
+    std::vector<int> events(state.range(0), 1);
+    for (auto _ : state) {
+        received = 0;
+        dispatcher::publish_batch<ThroughputEvent, LatencyNetwork>(std::span<const int>{events});
+        while (received != state.range(0)) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    connection.disconnect();
+}
+
+// Emission alone, with the given number of subscribers, through boost::signals2 and through the subscriber list of the
+// dispatcher
+static void EmitSignals2(benchmark::State &state)
+{
+    boost::signals2::signal<void(int)> signal;
+    int received = 0;
+    for (int i = 0; i < state.range(0); i++) {
+        signal.connect([&received](int value) { received += value; });
+    }
+    for (auto _ : state) {
+        signal(1);
+    }
+    bm::DoNotOptimize(received);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void EmitSubscriberList(benchmark::State &state)
+{
+    dispatcher::internal::SubscriberList<void(int)> subscribers;
+    int received = 0;
+    for (int i = 0; i < state.range(0); i++) {
+        subscribers.Connect([&received](int value) { received += value; });
+    }
+    for (auto _ : state) {
+        subscribers(1);
+    }
+    bm::DoNotOptimize(received);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+struct FanOutEvent {
+    using parameters_t = std::tuple<int>;
+};
+
+// End to end publish of 100 events to the given number of subscribers
+static void PublishSubscribers(benchmark::State &state)
+{
+    constexpr int events = 100;
+    const int subscribers = state.range(0);
+    std::atomic<int> received{0};
+    std::vector<dispatcher::Connection> connections;
+    for (int i = 0; i < subscribers; i++) {
+        connections.push_back(dispatcher::subscribe<FanOutEvent, LatencyNetwork>(
+            [&received](int value) { received.fetch_add(value, std::memory_order_relaxed); }));
+    }
+    for (auto _ : state) {
+        received = 0;
+        for (int i = 0; i < events; i++) {
+            dispatcher::publish<FanOutEvent, LatencyNetwork>(1);
+        }
+        while (received != events * subscribers) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * events * subscribers);
+    for (auto &connection : connections) {
+        connection.disconnect();
+    }
+}
+
+struct FilteredSignal {
+    using parameters_t = std::tuple<int, int>;
+};
+
+struct KeyedSignal {
+    using key_t = int;
+    using parameters_t = std::tuple<int>;
+};
+
+// 1000 subscribers each interested in one key out of 1000, filtering in the handler or indexed by key
+static void PublishFilteredInHandler(benchmark::State &state)
+{
+    constexpr int keys = 1000;
+    std::atomic<int> received{0};
+    std::vector<dispatcher::Connection> connections;
+    for (int key = 0; key < keys; key++) {
+        connections.push_back(dispatcher::subscribe<FilteredSignal, LatencyNetwork>([key, &received](int k, int value) {
+            if (k == key) {
+                received += value;
+            }
+        }));
+    }
+    for (auto _ : state) {
+        received = 0;
+        for (int key = 0; key < 100; key++) {
+            dispatcher::publish<FilteredSignal, LatencyNetwork>(key, 1);
+        }
+        while (received != 100) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 100);
+    for (auto &connection : connections) {
+        connection.disconnect();
+    }
+}
+
+static void PublishKeyed(benchmark::State &state)
+{
+    constexpr int keys = 1000;
+    std::atomic<int> received{0};
+    std::vector<dispatcher::Connection> connections;
+    for (int key = 0; key < keys; key++) {
+        connections.push_back(dispatcher::subscribe<KeyedSignal, LatencyNetwork>(
+            key, [&received](int value) { received += value; }));
+    }
+    for (auto _ : state) {
+        received = 0;
+        for (int key = 0; key < 100; key++) {
+            dispatcher::publish<KeyedSignal, LatencyNetwork>(key, 1);
+        }
+        while (received != 100) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 100);
+    for (auto &connection : connections) {
+        connection.disconnect();
+    }
+}
+
+// Both networks cache enough stacks for all the fibers, so that only the placement of the stacks differs
+struct ContextSwitchNetwork {
+    static constexpr std::size_t stack_cache_high_watermark = 2048;
+};
+
+struct ArenaNetwork {
+    static constexpr std::size_t stack_cache_high_watermark = 2048;
+    static constexpr std::size_t stack_arena_size = 64 * 1024 * 1024;
+};
+
+struct GatedEvent {
+    using parameters_t = std::tuple<>;
+};
+
+// Publish events whose subscriber waits until all of them are running, then yields repeatedly. This keeps one fiber per
+// event alive and switches between all of their stacks.
+template <typename Network>
+static void PublishContextSwitches(benchmark::State &state)
+{
+    const int events = state.range(0);
+    std::atomic<int> arrived{0};
+    std::atomic<int> done{0};
+    boost::fibers::promise<void> gate;
+    boost::fibers::shared_future<void> gate_future;
+    auto connection = dispatcher::subscribe<GatedEvent, Network>([&] {
+        if (++arrived == events) {
+            gate.set_value();
+        } else {
+            gate_future.wait();
+        }
+        for (int i = 0; i < 10; i++) {
+            boost::this_fiber::yield();
+        }
+        done++;
+    });
+    for (auto _ : state) {
+        state.PauseTiming();
+        arrived = 0;
+        done = 0;
+        gate = boost::fibers::promise<void>{};
+        gate_future = gate.get_future().share();
+        state.ResumeTiming();
+
+        for (int i = 0; i < events; i++) {
+            dispatcher::publish<GatedEvent, Network>();
+        }
+        while (done != events) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * events);
+    connection.disconnect();
+}
+
+static void AsyncCallAdditionEach(benchmark::State &state)
+{
+    dispatcher::attach<Addition>([](int a, int b) { return a + b; });
+    const auto calls = state.range(0);
+    std::vector<boost::fibers::future<int>> futures;
+    futures.reserve(calls);
+    for (auto _ : state) {
+        for (int i = 0; i < calls; i++) {
+            futures.push_back(dispatcher::async_call<Addition>(i, 1));
+        }
+        for (auto &future : futures) {
+            bm::DoNotOptimize(future.get());
+        }
+        futures.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * calls);
+}
+
+static void AsyncCallAdditionBatch(benchmark::State &state)
+{
+    dispatcher::attach<Addition>([](int a, int b) { return a + b; });
+    const auto calls = state.range(0);
+    std::vector<std::tuple<int, int>> batch;
+    for (int i = 0; i < calls; i++) {
+        batch.emplace_back(i, 1);
+    }
+    for (auto _ : state) {
+        bm::DoNotOptimize(dispatcher::async_call_batch<Addition>(batch).get());
+    }
+    state.SetItemsProcessed(state.iterations() * calls);
+}
+
+struct PriorityNetwork {};
+
+struct LowPriorityCheck {
+    using args_t = std::tuple<>;
+    using return_t = void;
+    static constexpr dispatcher::Priority priority = dispatcher::Priority::Low;
+};
+
+struct HighPriorityCheck {
+    using args_t = std::tuple<>;
+    using return_t = void;
+    static constexpr dispatcher::Priority priority = dispatcher::Priority::High;
+};
+
+// Latency of an asynchronous call posted right after a burst of low priority telemetry tasks
+template <typename CheckSignature>
+static void AsyncCallBehindTelemetryBurst(benchmark::State &state)
+{
+    dispatcher::attach<CheckSignature>([] {});
+    const auto burst = state.range(0);
+    std::atomic<int> drained{0};
+    for (auto _ : state) {
+        drained = 0;
+        for (int i = 0; i < burst; i++) {
+            dispatcher::post<dispatcher::Priority::Low, PriorityNetwork>([&drained] {
+                for (int j = 0; j < 100; j++) {
+                    bm::DoNotOptimize(j);
+                }
+                drained++;
+            });
+        }
+        auto start = std::chrono::steady_clock::now();
+        dispatcher::async_call<CheckSignature, PriorityNetwork>().get();
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        while (drained != burst) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+struct StaleNetwork {};
+
+struct SlowRequest {
+    using args_t = std::tuple<>;
+    using return_t = void;
+};
+
+// Latency of an asynchronous call posted right after a backlog of slow requests, whose deadline already passed when
+// the second argument is 1. The stale requests are then dropped instead of run.
+static void AsyncCallBehindStaleBacklog(benchmark::State &state)
+{
+    dispatcher::attach<SlowRequest>([] {
+        for (int j = 0; j < 10000; j++) {
+            bm::DoNotOptimize(j);
+        }
+    });
+    dispatcher::attach<Addition>([](int a, int b) { return a + b; });
+    const auto backlog = state.range(0);
+    dispatcher::CallOptions options;
+    if (state.range(1)) {
+        options.deadline = std::chrono::steady_clock::now();
+    }
+    std::vector<boost::fibers::future<void>> requests;
+    for (auto _ : state) {
+        requests.clear();
+        for (int i = 0; i < backlog; i++) {
+            requests.push_back(dispatcher::async_call<SlowRequest, StaleNetwork>(options));
+        }
+        auto start = std::chrono::steady_clock::now();
+        bm::DoNotOptimize(dispatcher::async_call<Addition, StaleNetwork>(1, 2).get());
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+struct FlowNetwork {};
+
+struct StageOne {
+    using args_t = std::tuple<int>;
+    using return_t = int;
+};
+
+struct StageTwo {
+    using args_t = std::tuple<int>;
+    using return_t = int;
+};
+
+struct StageThree {
+    using args_t = std::tuple<int>;
+    using return_t = int;
+};
+
+struct BlockingFlow {
+    using args_t = std::tuple<int>;
+    using return_t = int;
+};
+
+static void AttachStages()
+{
+    dispatcher::attach<StageOne>([](int value) { return value + 1; });
+    dispatcher::attach<StageTwo>([](int value) { return value * 2; });
+    dispatcher::attach<StageThree>([](int value) { return value - 1; });
+}
+
+// Flows of three chained calls, each flow running in a fiber blocked on the result of every stage
+static void ThreeStageFlowBlocking(benchmark::State &state)
+{
+    AttachStages();
+    dispatcher::attach<BlockingFlow>([](int value) {
+        auto one = dispatcher::async_call<StageOne, FlowNetwork>(value).get();
+        auto two = dispatcher::async_call<StageTwo, FlowNetwork>(one).get();
+        return dispatcher::async_call<StageThree, FlowNetwork>(two).get();
+    });
+    std::vector<dispatcher::Future<int>> flows;
+    for (auto _ : state) {
+        flows.clear();
+        for (int i = 0; i < state.range(0); i++) {
+            flows.push_back(dispatcher::async_call<BlockingFlow, FlowNetwork>(i));
+        }
+        for (auto &flow : flows) {
+            bm::DoNotOptimize(flow.get());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Same flows, the stages being chained with continuations so that no fiber waits for them
+static void ThreeStageFlowContinuations(benchmark::State &state)
+{
+    AttachStages();
+    std::vector<dispatcher::Future<int>> flows;
+    for (auto _ : state) {
+        flows.clear();
+        for (int i = 0; i < state.range(0); i++) {
+            flows.push_back(
+                dispatcher::async_call<StageOne, FlowNetwork>(i)
+                    .then<FlowNetwork>([](int one) { return dispatcher::async_call<StageTwo, FlowNetwork>(one); })
+                    .then<FlowNetwork>([](int two) { return dispatcher::async_call<StageThree, FlowNetwork>(two); }));
+        }
+        bm::DoNotOptimize(dispatcher::when_all(std::move(flows)).get());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static dispatcher::Coroutine<int> ThreeStageFlow(int value)
+{
+    auto one = co_await dispatcher::async_call<StageOne, FlowNetwork>(value);
+    auto two = co_await dispatcher::async_call<StageTwo, FlowNetwork>(one);
+    co_return co_await dispatcher::async_call<StageThree, FlowNetwork>(two);
+}
+
+// Same flows written as coroutines, suspended on every stage without holding a fiber
+static void ThreeStageFlowCoroutines(benchmark::State &state)
+{
+    AttachStages();
+    std::vector<dispatcher::Future<int>> flows;
+    for (auto _ : state) {
+        flows.clear();
+        for (int i = 0; i < state.range(0); i++) {
+            flows.push_back(dispatcher::spawn<FlowNetwork>(ThreeStageFlow(i)));
+        }
+        bm::DoNotOptimize(dispatcher::when_all(std::move(flows)).get());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+struct TimerNetwork {};
+
+// Arm and cancel timers spread over 100 s while as many others stay armed, e.g. per-entity timeouts
+static void ArmAndCancelTimers(benchmark::State &state)
+{
+    auto count = static_cast<std::size_t>(state.range(0));
+    auto armed = std::make_unique<dispatcher::Timer<TimerNetwork>[]>(count);
+    auto rearmed = std::make_unique<dispatcher::Timer<TimerNetwork>[]>(count);
+    for (std::size_t i = 0; i < count; i++) {
+        armed[i].DoIn(std::chrono::milliseconds{1000 + (i * 7919) % 100000}, [] {});
+    }
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < count; i++) {
+            rearmed[i].DoIn(std::chrono::milliseconds{1000 + (i * 104729) % 100000}, [] {});
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            rearmed[i].Cancel();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Timers expiring over 100 ms, until the callbacks of all of them ran
+static void ExpireTimers(benchmark::State &state)
+{
+    auto count = static_cast<std::size_t>(state.range(0));
+    auto timers = std::make_unique<dispatcher::Timer<TimerNetwork>[]>(count);
+    std::atomic<std::size_t> expired{0};
+    for (auto _ : state) {
+        expired = 0;
+        std::promise<void> done;
+        for (std::size_t i = 0; i < count; i++) {
+            timers[i].DoIn(std::chrono::milliseconds{i % 100}, [&] {
+                if (++expired == count) {
+                    done.set_value();
+                }
+            });
+        }
+        done.get_future().wait();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
 BENCHMARK(CallAdditionDirectly);
 BENCHMARK(CallAdditionVirtual);
+BENCHMARK(CallAdditionStdFunction);
+BENCHMARK(CallAdditionInplaceFunction);
 BENCHMARK(CallAdditionFunctionDispatcher);
+BENCHMARK(CallAdditionStaticDispatcher);
+BENCHMARK(CallMissingHandlerThrowing);
+BENCHMARK(CallMissingHandlerTryCall);
 BENCHMARK(CallManipulateStringDirectly);
 BENCHMARK(CallManipulateStringVirtual);
 BENCHMARK(CallManipulateStringFunctionDispatcher);
 BENCHMARK(CallManipulateStringRefDirectly);
 BENCHMARK(CallManipulateStringRefVirtual);
 BENCHMARK(CallManipulateStringRefFunctionDispatcher);
+BENCHMARK(AsyncCallAdditionEach)->Arg(1000)->UseRealTime();
+BENCHMARK(AsyncCallAdditionBatch)->Arg(1000)->UseRealTime();
+BENCHMARK_TEMPLATE(AsyncCallBehindTelemetryBurst, LowPriorityCheck)->Arg(1000)->UseManualTime();
+BENCHMARK_TEMPLATE(AsyncCallBehindTelemetryBurst, HighPriorityCheck)->Arg(1000)->UseManualTime();
+BENCHMARK(AsyncCallBehindStaleBacklog)->Args({1000, 0})->Args({1000, 1})->UseManualTime();
+BENCHMARK(ThreeStageFlowBlocking)->Arg(100)->UseRealTime();
+BENCHMARK(ThreeStageFlowContinuations)->Arg(100)->UseRealTime();
+BENCHMARK(ThreeStageFlowCoroutines)->Arg(100)->UseRealTime();
+BENCHMARK(ArmAndCancelTimers)->Arg(100000)->UseRealTime();
+BENCHMARK(ExpireTimers)->Arg(100000)->UseRealTime();
+BENCHMARK(PostLatency)->UseRealTime();
+BENCHMARK(FiberWakeUpLatency)->UseRealTime();
+BENCHMARK(PublishThroughput)->Arg(1000)->UseRealTime();
+BENCHMARK(PublishBoundedThroughput)->Arg(1000)->UseRealTime();
+BENCHMARK(PublishLatestThroughput)->Arg(1000)->UseRealTime();
+BENCHMARK(PublishBatchThroughput)->Arg(1000)->UseRealTime();
+BENCHMARK(EmitSignals2)->Arg(1)->Arg(10)->Arg(1000);
+BENCHMARK(EmitSubscriberList)->Arg(1)->Arg(10)->Arg(1000);
+BENCHMARK(PublishSubscribers)->Arg(1)->Arg(10)->Arg(1000)->UseRealTime();
+BENCHMARK(PublishFilteredInHandler)->UseRealTime();
+BENCHMARK(PublishKeyed)->UseRealTime();
+BENCHMARK_TEMPLATE(PublishContextSwitches, ContextSwitchNetwork)->Arg(1000)->UseRealTime();
+BENCHMARK_TEMPLATE(PublishContextSwitches, ArenaNetwork)->Arg(1000)->UseRealTime();
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -17,24 +17,215 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/fiber/all.hpp>
 #include <boost/optional.hpp>
-#include <boost/signals2.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <functional>
-#include <queue>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
 #include <thread>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <variant>
 #include <vector>
 
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <linux/membarrier.h>
+
 namespace dispatcher {
+
+/**
+ * @brief Priority lane of the tasks, events and asynchronous calls of a network.
+ */
+enum class Priority {
+    Low,     ///< Background work, e.g. telemetry
+    Normal,  ///< Default priority
+    High     ///< Latency-sensitive work, run before the other lanes
+};
+
+/**
+ * @brief What publishing does when the bounded event queue of an event signature is full.
+ */
+enum class OverflowPolicy {
+    Block,       ///< The publisher is suspended until an event is taken from the queue
+    DropNewest,  ///< The published event is dropped, the default
+    DropOldest,  ///< The oldest queued event is dropped to make room for the published one
+    Fail         ///< The publisher is handed the failure, see `publish` and `try_publish`
+};
+
 namespace internal {
 
-template <typename ReturnType, typename Tuple>
+// Move-only replacement of std::function. Callables of up to Capacity bytes that can be moved without throwing are
+// stored in place, larger ones on the heap. Calling an empty function throws std::bad_function_call.
+template <typename Signature, std::size_t Capacity = 32>
+class InplaceFunction;
+
+template <typename ReturnType, typename... Args, std::size_t Capacity>
+class InplaceFunction<ReturnType(Args...), Capacity> {
+    template <typename F>
+    using enable_if_callable =
+        std::enable_if_t<!std::is_same<std::decay_t<F>, InplaceFunction>::value &&
+                         !std::is_same<std::decay_t<F>, std::nullptr_t>::value>;
+
+  public:
+    // Fully initialized so that empty functions can be constant initialized
+    constexpr InplaceFunction() noexcept : storage_{}
+    {
+    }
+    constexpr InplaceFunction(std::nullptr_t) noexcept : InplaceFunction()
+    {
+    }
+    template <typename F, typename = enable_if_callable<F>>
+    InplaceFunction(F &&callable)
+    {
+        using callable_type = std::decay_t<F>;
+        if constexpr (StoredInPlace<callable_type>()) {
+            new (storage_) callable_type(std::forward<F>(callable));
+        } else {
+            new (storage_) callable_type *(new callable_type(std::forward<F>(callable)));
+        }
+        invoke_ = &Invoke<callable_type>;
+        manage_ = &Manage<callable_type>;
+    }
+    InplaceFunction(InplaceFunction &&other) noexcept
+    {
+        MoveFrom(other);
+    }
+    ~InplaceFunction()
+    {
+        Reset();
+    }
+
+    InplaceFunction &operator=(InplaceFunction &&other) noexcept
+    {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+    InplaceFunction &operator=(std::nullptr_t) noexcept
+    {
+        Reset();
+        return *this;
+    }
+    template <typename F, typename = enable_if_callable<F>>
+    InplaceFunction &operator=(F &&callable)
+    {
+        return *this = InplaceFunction{std::forward<F>(callable)};
+    }
+
+    InplaceFunction(const InplaceFunction &) = delete;
+    InplaceFunction &operator=(const InplaceFunction &) = delete;
+
+    explicit operator bool() const noexcept
+    {
+        return manage_ != nullptr;
+    }
+
+    ReturnType operator()(Args... args) const
+    {
+        return invoke_(storage_, std::forward<Args>(args)...);
+    }
+
+  private:
+    enum class Operation { Move, Destroy };
+
+    template <typename T>
+    static constexpr bool StoredInPlace()
+    {
+        return sizeof(T) <= Capacity && alignof(T) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible<T>::value;
+    }
+
+    template <typename T>
+    static T &Get(void *storage)
+    {
+        if constexpr (StoredInPlace<T>()) {
+            return *static_cast<T *>(storage);
+        } else {
+            return **static_cast<T **>(storage);
+        }
+    }
+
+    template <typename T>
+    static ReturnType Invoke(void *storage, Args &&...args)
+    {
+        return Get<T>(storage)(std::forward<Args>(args)...);
+    }
+
+    static ReturnType InvokeEmpty(void *, Args &&...)
+    {
+        throw std::bad_function_call();
+    }
+
+    template <typename T>
+    static void Manage(Operation operation, void *storage, void *destination)
+    {
+        if constexpr (StoredInPlace<T>()) {
+            if (operation == Operation::Move) {
+                new (destination) T(std::move(Get<T>(storage)));
+            }
+            Get<T>(storage).~T();
+        } else {
+            if (operation == Operation::Move) {
+                new (destination) T *(*static_cast<T **>(storage));
+            } else {
+                delete *static_cast<T **>(storage);
+            }
+        }
+    }
+
+    void MoveFrom(InplaceFunction &other) noexcept
+    {
+        if (other.manage_) {
+            other.manage_(Operation::Move, other.storage_, storage_);
+            invoke_ = std::exchange(other.invoke_, &InvokeEmpty);
+            manage_ = std::exchange(other.manage_, nullptr);
+        }
+    }
+
+    void Reset() noexcept
+    {
+        if (manage_) {
+            manage_(Operation::Destroy, storage_, nullptr);
+            invoke_ = &InvokeEmpty;
+            manage_ = nullptr;
+        }
+    }
+
+    ReturnType (*invoke_)(void *, Args &&...) = &InvokeEmpty;
+    void (*manage_)(Operation, void *, void *) = nullptr;
+    alignas(std::max_align_t) mutable unsigned char storage_[Capacity];
+};
+
+template <typename ReturnType, typename Tuple, std::size_t Capacity = 32>
 struct FunctionFromTuple;
 
-template <typename ReturnType, typename... Args>
-struct FunctionFromTuple<ReturnType, std::tuple<Args...>> {
-    using type = std::function<ReturnType(Args...)>;
+template <typename ReturnType, typename... Args, std::size_t Capacity>
+struct FunctionFromTuple<ReturnType, std::tuple<Args...>, Capacity> {
+    using type = InplaceFunction<ReturnType(Args...), Capacity>;
 };
 
 template <typename ReturnType, typename Tuple>
@@ -48,9 +239,129 @@ struct ReturnTypeFromCallable<Callable, std::tuple<Args...>> {
 template <typename Tuple>
 struct SignalFromTuple;
 
+template <typename Signature>
+class SubscriberList;
+
 template <typename... Parameters>
 struct SignalFromTuple<std::tuple<Parameters...>> {
-    using type = boost::signals2::signal<void(Parameters...)>;
+    using type = SubscriberList<void(Parameters...)>;
+};
+
+// Value type of one event in a batch: the decayed parameter, or a tuple of them when there are several
+template <typename... Parameters>
+struct EventType {
+    using type = std::tuple<std::decay_t<Parameters>...>;
+};
+
+template <typename Parameter>
+struct EventType<Parameter> {
+    using type = std::decay_t<Parameter>;
+};
+
+template <typename Tuple>
+struct DecayedTuple;
+
+template <typename... Parameters>
+struct DecayedTuple<std::tuple<Parameters...>> {
+    using type = std::tuple<std::decay_t<Parameters>...>;
+};
+
+// Events published together, dispatched by a single task. The batch subscribers receive all of them at once, as a span
+// of events, or as one span per parameter when the batch is columnar. The other subscribers are then called once per
+// event.
+template <typename Parameters, bool columnar>
+class EventBatch;
+
+template <typename... Parameters>
+class EventBatch<std::tuple<Parameters...>, false> {
+  public:
+    using event_t = typename EventType<Parameters...>::type;
+    using batch_signal_type = SubscriberList<void(std::span<const event_t>)>;
+
+    template <typename Range>
+    explicit EventBatch(Range &&events) : events_(std::ranges::begin(events), std::ranges::end(events))
+    {
+    }
+
+    template <typename Signal>
+    void Dispatch(batch_signal_type &batch_signal, Signal &signal) const
+    {
+        batch_signal(std::span<const event_t>{events_});
+        for (const auto &event : events_) {
+            if constexpr (sizeof...(Parameters) == 1) {
+                signal(event);
+            } else {
+                std::apply(signal, event);
+            }
+        }
+    }
+
+    // Delivers a single published event to the batch subscribers
+    template <typename Tuple>
+    static void DispatchOne(batch_signal_type &batch_signal, const Tuple &parameters)
+    {
+        const event_t event = std::make_from_tuple<event_t>(parameters);
+        batch_signal(std::span<const event_t>{&event, 1});
+    }
+
+  private:
+    std::vector<event_t> events_;
+};
+
+template <typename... Parameters>
+class EventBatch<std::tuple<Parameters...>, true> {
+    static_assert((std::is_trivially_copyable<std::decay_t<Parameters>>::value && ...),
+                  "Columnar batches need trivially copyable parameters");
+
+  public:
+    using event_t = typename EventType<Parameters...>::type;
+    using batch_signal_type = SubscriberList<void(std::span<const std::decay_t<Parameters>>...)>;
+
+    template <typename Range>
+    explicit EventBatch(Range &&events)
+    {
+        if constexpr (std::ranges::sized_range<Range>) {
+            std::apply([&](auto &...columns) { (columns.reserve(std::ranges::size(events)), ...); }, columns_);
+        }
+        for (const auto &event : events) {
+            Append(event, std::index_sequence_for<Parameters...>{});
+        }
+    }
+
+    template <typename Signal>
+    void Dispatch(batch_signal_type &batch_signal, Signal &signal) const
+    {
+        DispatchColumns(batch_signal, signal, std::index_sequence_for<Parameters...>{});
+    }
+
+    template <typename Tuple>
+    static void DispatchOne(batch_signal_type &batch_signal, const Tuple &parameters)
+    {
+        const std::tuple<std::decay_t<Parameters>...> event = parameters;
+        std::apply([&](const auto &...values) { batch_signal(std::span{&values, 1}...); }, event);
+    }
+
+  private:
+    template <std::size_t... Is>
+    void Append(const event_t &event, std::index_sequence<Is...>)
+    {
+        if constexpr (sizeof...(Parameters) == 1) {
+            std::get<0>(columns_).push_back(event);
+        } else {
+            (std::get<Is>(columns_).push_back(std::get<Is>(event)), ...);
+        }
+    }
+
+    template <typename Signal, std::size_t... Is>
+    void DispatchColumns(batch_signal_type &batch_signal, Signal &signal, std::index_sequence<Is...>) const
+    {
+        batch_signal(std::span<const std::decay_t<Parameters>>{std::get<Is>(columns_)}...);
+        for (std::size_t i = 0; i < std::get<0>(columns_).size(); ++i) {
+            signal(std::get<Is>(columns_)[i]...);
+        }
+    }
+
+    std::tuple<std::vector<std::decay_t<Parameters>>...> columns_;
 };
 
 template <typename...>
@@ -104,447 +415,4828 @@ struct parameters_t_or_default<EventSignature, true> {
     using type = typename EventSignature::parameters_t;
 };
 
-// Default network
-struct Default {};
+template <typename EventSignature, typename = void>
+struct has_key_t : std::false_type {};
 
-}  // namespace internal
+template <typename EventSignature>
+struct has_key_t<EventSignature, void_t<typename EventSignature::key_t>> : std::true_type {};
 
-struct DispatcherException : std::exception {};
+template <typename EventSignature, bool HasKeyT>
+struct key_t_or_default {
+    using type = void;
+};
 
-template <typename FuncSignature>
-class NoHandler : public DispatcherException {
-  public:
-    const char *what() const noexcept override
-    {
-        static std::string message =
-            "No handler were found for FuncSignature: " + std::string(typeid(FuncSignature).name());
-        return message.c_str();
-    }
+template <typename EventSignature>
+struct key_t_or_default<EventSignature, true> {
+    using type = typename EventSignature::key_t;
 };
 
-namespace internal {
+// Function bound to a signature at compile time, specialized by DISPATCHER_ATTACH_STATIC
+template <typename FuncSignature>
+struct StaticHandler {};
 
-template <typename FuncSignature, typename func_type>
-func_type &GetFunction()
-{
-    static func_type function;
-    return function;
-}
+template <typename FuncSignature, typename = void>
+struct has_static_handler : std::false_type {};
 
 template <typename FuncSignature>
-struct FunctionDispatcher {
-    template <typename Callable>
-    static void attach(Callable &&callable)
-    {
-        GetFunction<FuncSignature, func_type>() = std::forward<Callable>(callable);
-    }
+struct has_static_handler<FuncSignature, void_t<decltype(StaticHandler<FuncSignature>::function)>> : std::true_type {};
 
-    static void detach()
-    {
-        GetFunction<FuncSignature, func_type>() = nullptr;
-    }
+template <typename FuncSignature, typename = void>
+struct handler_storage_size_or_default {
+    static constexpr std::size_t value = 32;
+};
 
-    template <typename... Args>
-    static auto call(Args &&...args)
-    {
-        try {
-            return GetFunction<FuncSignature, func_type>()(std::forward<Args>(args)...);
-        } catch (const std::bad_function_call &) {
-            throw NoHandler<FuncSignature>{};
-        }
-    }
+template <typename FuncSignature>
+struct handler_storage_size_or_default<FuncSignature, void_t<decltype(FuncSignature::handler_storage_size)>> {
+    static constexpr std::size_t value = FuncSignature::handler_storage_size;
+};
 
-    using return_t = typename return_t_or_default<FuncSignature, has_return_t<FuncSignature>::value>::type;
-    using args_t = typename args_t_or_default<FuncSignature, has_args_t<FuncSignature>::value>::type;
+template <typename Network, typename = void>
+struct has_ingress_queue_capacity : std::false_type {};
 
-    using func_type = typename FunctionFromTuple<return_t, args_t>::type;
+template <typename Network>
+struct has_ingress_queue_capacity<Network, void_t<decltype(Network::ingress_queue_capacity)>> : std::true_type {};
+
+template <typename Network, typename = void>
+struct ingress_task_size_or_default {
+    static constexpr std::size_t value = 64;
 };
 
-class MemoryPool {
-  public:
-    MemoryPool(std::size_t size) : size_(size)
-    {
-    }
-    ~MemoryPool()
-    {
-        while (!allocated_blocks_.empty()) {
-            auto memory_block = allocated_blocks_.front();
-            allocated_blocks_.pop();
-            std::free(memory_block);
-        }
-    }
-    MemoryPool(const MemoryPool &) = delete;
-    MemoryPool(MemoryPool &&) = delete;
-    MemoryPool &operator=(const MemoryPool &) = delete;
-    MemoryPool &operator=(MemoryPool &&) = delete;
+template <typename Network>
+struct ingress_task_size_or_default<Network, void_t<decltype(Network::ingress_task_size)>> {
+    static constexpr std::size_t value = Network::ingress_task_size;
+};
 
-    void *allocate()
-    {
-        if (allocated_blocks_.empty()) {
-            void *memory = std::malloc(size_);
-            if (!memory) {
-                throw std::bad_alloc();
-            }
-            return memory;
-        }
-        auto memory = allocated_blocks_.front();
-        allocated_blocks_.pop();
-        return memory;
-    }
-    void free(void *memory_block)
-    {
-        allocated_blocks_.push(memory_block);
-    }
+// Whether a task can be posted to the network: always, unless the slots of its ingress queue are too small for it
+template <typename Network, typename T, bool = has_ingress_queue_capacity<Network>::value>
+struct fits_ingress_queue : std::true_type {};
 
-    std::size_t get_size()
-    {
-        return size_;
-    }
+template <typename Network, typename T>
+struct fits_ingress_queue<Network, T, true>
+    : std::bool_constant<sizeof(std::decay_t<T>) <= ingress_task_size_or_default<Network>::value &&
+                         alignof(std::decay_t<T>) <= alignof(std::max_align_t)> {};
 
-  private:
-    std::size_t size_;
-    std::queue<void *> allocated_blocks_;
-};
+template <typename T, typename = void>
+struct is_non_suspending : std::false_type {};
 
-inline MemoryPool &GetMemoryPool()
-{
-    thread_local MemoryPool memory_pool{30000};
-    return memory_pool;
-}
+template <typename T>
+struct is_non_suspending<T, void_t<decltype(T::non_suspending)>> : std::integral_constant<bool, T::non_suspending> {};
 
-class CustomStackAllocator {
-  public:
-    CustomStackAllocator()
-    {
-    }
+template <typename T, typename = void>
+struct is_zero_copy : std::false_type {};
 
-    boost::context::stack_context allocate()
-    {
-        boost::context::stack_context sctx;
-        sctx.size = GetMemoryPool().get_size();
-        sctx.sp = static_cast<char *>(GetMemoryPool().allocate()) + sctx.size;
-        return sctx;
-    }
+template <typename T>
+struct is_zero_copy<T, void_t<decltype(T::zero_copy)>> : std::integral_constant<bool, T::zero_copy> {};
 
-    void deallocate(boost::context::stack_context &sctx)
-    {
-        BOOST_ASSERT(sctx.sp);
+template <typename T, typename = void>
+struct is_conflating : std::false_type {};
 
-        void *vp = static_cast<char *>(sctx.sp) - sctx.size;
-        GetMemoryPool().free(vp);
-    }
+template <typename T>
+struct is_conflating<T, void_t<decltype(T::conflate)>> : std::integral_constant<bool, T::conflate> {};
+
+template <typename T, typename = void>
+struct is_columnar_batch : std::false_type {};
+
+template <typename T>
+struct is_columnar_batch<T, void_t<decltype(T::columnar_batch)>> : std::integral_constant<bool, T::columnar_batch> {};
+
+template <typename Network, typename = void>
+struct stack_cache_low_watermark_or_default {
+    static constexpr std::size_t value = 8;
 };
 
 template <typename Network>
-class EventLoop {
-  public:
-    EventLoop()
-        : work_guard_{boost::asio::make_work_guard(io_context_)},
-          work_thread_{[this] {
-              while (!stopped_) {
-                  io_context_.run_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
-                  boost::this_fiber::yield();
-              }
-          }}
-    {
-    }
-    ~EventLoop()
-    {
-        Stop();
-    }
+struct stack_cache_low_watermark_or_default<Network, void_t<decltype(Network::stack_cache_low_watermark)>> {
+    static constexpr std::size_t value = Network::stack_cache_low_watermark;
+};
 
-    EventLoop(const EventLoop &) = delete;
-    EventLoop(EventLoop &&) = delete;
-    EventLoop &operator=(const EventLoop &) = delete;
-    EventLoop &operator=(EventLoop &&) = delete;
+template <typename Network, typename = void>
+struct stack_cache_high_watermark_or_default {
+    static constexpr std::size_t value = 128;
+};
 
-    template <typename T>
-    void Post(T &&task)
-    {
-        boost::asio::post(io_context_, [this, task = std::forward<T>(task)]() mutable {
-            boost::fibers::fiber(boost::fibers::launch::dispatch, std::allocator_arg, CustomStackAllocator{},
-                                 std::forward<T>(task))
-                .detach();
-        });
-    }
+template <typename Network>
+struct stack_cache_high_watermark_or_default<Network, void_t<decltype(Network::stack_cache_high_watermark)>> {
+    static constexpr std::size_t value = Network::stack_cache_high_watermark;
+};
 
-    void Stop()
-    {
-        work_guard_.reset();
-        io_context_.stop();
-        stopped_ = true;
+// Stack size of the fibers running the tasks of a network or signature, 0 if the signature does not override it
+template <typename T, std::size_t Default = 0, typename = void>
+struct stack_size_or_default {
+    static constexpr std::size_t value = Default;
+};
 
-        if (work_thread_.joinable()) {
-            work_thread_.join();
-        }
-        for (auto &thread : additional_work_threads_) {
-            if (thread.joinable()) {
-                thread.join();
-            }
-        }
-    }
+template <typename T, std::size_t Default>
+struct stack_size_or_default<T, Default, void_t<decltype(T::stack_size)>> {
+    static constexpr std::size_t value = T::stack_size;
+};
 
-    boost::asio::io_context &GetIOContext()
+template <typename Network, typename = void>
+struct stack_arena_size_or_default {
+    static constexpr std::size_t value = 0;
+};
+
+template <typename Network>
+struct stack_arena_size_or_default<Network, void_t<decltype(Network::stack_arena_size)>> {
+    static constexpr std::size_t value = Network::stack_arena_size;
+};
+
+inline constexpr std::size_t kPriorityCount = 3;
+
+template <typename T, typename = void>
+struct priority_or_default {
+    static constexpr Priority value = Priority::Normal;
+};
+
+template <typename T>
+struct priority_or_default<T, void_t<decltype(T::priority)>> {
+    static constexpr Priority value = T::priority;
+};
+
+template <typename Network, typename = void>
+struct priority_starvation_limit_or_default {
+    static constexpr std::size_t value = 16;
+};
+
+template <typename Network>
+struct priority_starvation_limit_or_default<Network, void_t<decltype(Network::priority_starvation_limit)>> {
+    static constexpr std::size_t value = Network::priority_starvation_limit;
+};
+
+// Resolution of the timers of a network, in milliseconds
+template <typename Network, typename = void>
+struct timer_tick_ms_or_default {
+    static constexpr std::size_t value = 1;
+};
+
+template <typename Network>
+struct timer_tick_ms_or_default<Network, void_t<decltype(Network::timer_tick_ms)>> {
+    static constexpr std::size_t value = Network::timer_tick_ms;
+};
+
+// Bound of the queue of the events of a signature, 0 if unbounded. The event signature overrides its network
+template <typename T, std::size_t Default = 0, typename = void>
+struct event_queue_bound_or_default {
+    static constexpr std::size_t value = Default;
+};
+
+template <typename T, std::size_t Default>
+struct event_queue_bound_or_default<T, Default, void_t<decltype(T::event_queue_bound)>> {
+    static constexpr std::size_t value = T::event_queue_bound;
+};
+
+// Blocking is opt-in, a publisher that cannot wait for the event loop, e.g. a task of the loop itself, would deadlock
+template <typename T, OverflowPolicy Default = OverflowPolicy::DropNewest, typename = void>
+struct overflow_policy_or_default {
+    static constexpr OverflowPolicy value = Default;
+};
+
+template <typename T, OverflowPolicy Default>
+struct overflow_policy_or_default<T, Default, void_t<decltype(T::overflow_policy)>> {
+    static constexpr OverflowPolicy value = T::overflow_policy;
+};
+
+template <typename Network, typename = void>
+struct measures_queue_latency : std::false_type {};
+
+template <typename Network>
+struct measures_queue_latency<Network, void_t<decltype(Network::measure_queue_latency)>>
+    : std::integral_constant<bool, Network::measure_queue_latency> {};
+
+template <typename Network, typename = void>
+struct profiles_stack_usage : std::false_type {};
+
+template <typename Network>
+struct profiles_stack_usage<Network, void_t<decltype(Network::profile_stack_usage)>>
+    : std::integral_constant<bool, Network::profile_stack_usage> {};
+
+// Default network
+struct Default {};
+
+}  // namespace internal
+
+struct DispatcherException : std::exception {};
+
+/**
+ * @brief Result of a non-blocking push to the ingress queue of a network.
+ */
+enum class PostStatus {
+    Posted,    ///< The task was queued and will be executed by the event loop.
+    QueueFull  ///< The ingress queue was full, the task was dropped.
+};
+
+/**
+ * @brief Statistics of the fiber stack cache of a network.
+ */
+struct StackCacheStats {
+    std::size_t hits = 0;         ///< Stacks reused from the cache
+    std::size_t misses = 0;       ///< Stacks allocated because the cache was empty
+    std::size_t blocks_held = 0;  ///< Stacks currently held by the cache, ready to be reused
+    std::size_t bytes_held = 0;   ///< Memory held by these stacks
+    std::size_t arena_bytes = 0;  ///< Memory reserved by the stack arena
+};
+
+/**
+ * @brief Stack usage measured while profiling the fiber stacks of a network.
+ */
+struct StackUsage {
+    std::size_t stack_size = 0;       ///< Size of the measured stacks, the largest one if they differ
+    std::size_t high_water_mark = 0;  ///< Largest amount of stack used, in bytes
+    std::size_t samples = 0;          ///< Number of measurements
+};
+
+/**
+ * @brief Stack usage of the fibers of a network, overall and per signature.
+ */
+struct StackProfile {
+    StackUsage network;                            ///< Every task and fiber stack of the network
+    std::map<std::string, StackUsage> signatures;  ///< Per FuncSignature or EventSignature, by their typeid name
+};
+
+/**
+ * @brief Counters of the bounded event queue of an event signature.
+ */
+struct EventQueueStats {
+    std::size_t depth = 0;               ///< Events currently queued
+    std::size_t high_water_depth = 0;    ///< Largest number of events queued at once
+    std::size_t dropped = 0;             ///< Events dropped by the DropNewest and DropOldest policies, or overwritten
+    std::size_t rejected = 0;            ///< Events handed back to the publisher by the Fail policy or `try_publish`
+    std::size_t blocked_publishers = 0;  ///< Publishers currently suspended by the Block policy
+};
+
+/**
+ * @brief Time spent by the tasks of one priority between being posted and starting to run.
+ */
+struct QueueLatency {
+    std::size_t samples = 0;           ///< Number of measured tasks
+    std::chrono::nanoseconds total{};  ///< Sum of their queue latencies
+    std::chrono::nanoseconds max{};    ///< Largest queue latency
+
+    std::chrono::nanoseconds mean() const
+    {
+        return samples ? total / static_cast<std::chrono::nanoseconds::rep>(samples) : std::chrono::nanoseconds{};
+    }
+};
+
+/**
+ * @brief Queue latencies of the tasks of a network, per priority.
+ */
+struct QueueLatencyStats {
+    std::array<QueueLatency, internal::kPriorityCount> priorities;  ///< Indexed by Priority
+
+    const QueueLatency &operator[](Priority priority) const
+    {
+        return priorities[static_cast<std::size_t>(priority)];
+    }
+};
+
+template <typename FuncSignature>
+class NoHandler : public DispatcherException {
+  public:
+    const char *what() const noexcept override
+    {
+        static std::string message =
+            "No handler were found for FuncSignature: " + std::string(typeid(FuncSignature).name());
+        return message.c_str();
+    }
+};
+
+template <typename EventSignature>
+class EventQueueFull : public DispatcherException {
+  public:
+    const char *what() const noexcept override
+    {
+        static std::string message =
+            "The event queue is full for EventSignature: " + std::string(typeid(EventSignature).name());
+        return message.c_str();
+    }
+};
+
+/**
+ * @brief Reason why a call returning a CallResult could not be dispatched.
+ */
+enum class CallError {
+    NoHandler,         ///< No callable is attached to the function signature.
+    DeadlineExceeded,  ///< The deadline of the call passed before it could run, see CallOptions.
+    Cancelled          ///< The call was cancelled before it could run, see CallOptions.
+};
+
+template <typename FuncSignature>
+class DeadlineExceeded : public DispatcherException {
+  public:
+    const char *what() const noexcept override
+    {
+        static std::string message =
+            "The deadline passed before calling FuncSignature: " + std::string(typeid(FuncSignature).name());
+        return message.c_str();
+    }
+};
+
+template <typename FuncSignature>
+class Cancelled : public DispatcherException {
+  public:
+    const char *what() const noexcept override
+    {
+        static std::string message =
+            "The call was cancelled for FuncSignature: " + std::string(typeid(FuncSignature).name());
+        return message.c_str();
+    }
+};
+
+/**
+ * @brief Shared flag cancelling the asynchronous calls it was passed to, see CallOptions.
+ *
+ * Copies share the same flag, so that the caller can keep a token and hand it to any number of calls. Cancelling only
+ * drops the calls which did not start running yet.
+ */
+class CancellationToken {
+  public:
+    CancellationToken() : cancelled_(std::make_shared<std::atomic<bool>>(false))
+    {
+    }
+
+    /// Cancels the calls holding this token or one of its copies, can be called from any thread.
+    void cancel() noexcept
+    {
+        cancelled_->store(true, std::memory_order_relaxed);
+    }
+
+    /// Whether the token or one of its copies was cancelled.
+    bool is_cancelled() const noexcept
+    {
+        return cancelled_->load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+/**
+ * @brief Conditions under which an asynchronous call is dropped instead of run.
+ *
+ * They are checked when the call is about to run, a call already running is not interrupted.
+ */
+struct CallOptions {
+    std::optional<std::chrono::steady_clock::time_point> deadline;  ///< The call is dropped once it passed
+    std::optional<CancellationToken> cancellation;                  ///< The call is dropped once it is cancelled
+
+    /// The reason why the call must be dropped, if any
+    std::optional<CallError> Check() const
+    {
+        if (cancellation && cancellation->is_cancelled()) {
+            return CallError::Cancelled;
+        }
+        if (deadline && std::chrono::steady_clock::now() >= *deadline) {
+            return CallError::DeadlineExceeded;
+        }
+        return std::nullopt;
+    }
+};
+
+/**
+ * @brief Number of asynchronous calls of a network dropped before running, see CallOptions.
+ */
+struct DroppedCallStats {
+    std::size_t deadline_exceeded = 0;  ///< Calls whose deadline passed while they were queued
+    std::size_t cancelled = 0;          ///< Calls cancelled while they were queued
+};
+
+/**
+ * @brief Thrown when accessing the value of a CallResult holding an error.
+ */
+class BadCallResultAccess : public DispatcherException {
+  public:
+    const char *what() const noexcept override
+    {
+        return "The call failed, its result holds no value";
+    }
+};
+
+/**
+ * @brief Result of a call which reports a missing handler without throwing.
+ *
+ * Holds either the value returned by the callable, or the CallError explaining why it could not be called.
+ *
+ * @tparam T The return type of the function signature, which can be a reference.
+ */
+template <typename T>
+class CallResult {
+    using stored_t =
+        std::conditional_t<std::is_reference<T>::value, std::reference_wrapper<std::remove_reference_t<T>>, T>;
+
+  public:
+    CallResult(T value) : result_(std::in_place_index<0>, std::forward<T>(value))
+    {
+    }
+    CallResult(CallError error) : result_(std::in_place_index<1>, error)
+    {
+    }
+
+    bool has_value() const noexcept
+    {
+        return result_.index() == 0;
+    }
+    explicit operator bool() const noexcept
+    {
+        return has_value();
+    }
+
+    /// @throws BadCallResultAccess If the call failed.
+    T &value() &
+    {
+        Check();
+        return std::get<0>(result_);
+    }
+    const T &value() const &
+    {
+        Check();
+        return std::get<0>(result_);
+    }
+    T &&value() &&
+    {
+        Check();
+        return static_cast<T &&>(std::get<0>(result_));
+    }
+
+    /// The value, the result must hold one.
+    T &operator*() &
+    {
+        return std::get<0>(result_);
+    }
+    const T &operator*() const &
+    {
+        return std::get<0>(result_);
+    }
+    std::remove_reference_t<T> *operator->()
+    {
+        return &static_cast<T &>(std::get<0>(result_));
+    }
+    const std::remove_reference_t<T> *operator->() const
+    {
+        return &static_cast<const T &>(std::get<0>(result_));
+    }
+
+    /// The error, the result must not hold a value.
+    CallError error() const
+    {
+        return std::get<1>(result_);
+    }
+
+  private:
+    void Check() const
+    {
+        if (!has_value()) {
+            throw BadCallResultAccess{};
+        }
+    }
+
+    std::variant<stored_t, CallError> result_;
+};
+
+template <>
+class CallResult<void> {
+  public:
+    CallResult() = default;
+    CallResult(CallError error) : error_(error)
+    {
+    }
+
+    bool has_value() const noexcept
+    {
+        return !error_;
+    }
+    explicit operator bool() const noexcept
+    {
+        return has_value();
+    }
+
+    /// @throws BadCallResultAccess If the call failed.
+    void value() const
+    {
+        if (error_) {
+            throw BadCallResultAccess{};
+        }
+    }
+
+    /// The error, the result must not hold a value.
+    CallError error() const
+    {
+        return *error_;
+    }
+
+  private:
+    std::optional<CallError> error_;
+};
+
+namespace internal {
+
+// Subscription of a callable to an event, disconnected through its Connection
+struct SubscriberSlot {
+    virtual ~SubscriberSlot() = default;
+    virtual void Disconnect() = 0;
+
+    std::atomic<bool> connected{true};
+};
+
+}  // namespace internal
+
+/**
+ * @brief Handle on the subscription of a callable to an event.
+ *
+ * Destroying or discarding the handle does not end the subscription, disconnect does. The handle does not keep the
+ * callable alive.
+ */
+class Connection {
+  public:
+    Connection() = default;
+    explicit Connection(std::weak_ptr<internal::SubscriberSlot> slot) : slot_(std::move(slot))
+    {
+    }
+
+    /// Ends the subscription, the callable is not invoked for the events dispatched afterwards.
+    void disconnect() const
+    {
+        if (auto slot = slot_.lock()) {
+            slot->Disconnect();
+        }
+    }
+
+    bool connected() const
+    {
+        auto slot = slot_.lock();
+        return slot && slot->connected.load(std::memory_order_acquire);
+    }
+
+  private:
+    std::weak_ptr<internal::SubscriberSlot> slot_;
+};
+
+/**
+ * @brief Immutable payload shared by every subscriber of an event, for event parameters too large to be copied.
+ *
+ * Declaring `Shared<T>` instead of `T` in `parameters_t` makes publish wrap the payload once in a reference-counted
+ * block. Every subscriber is handed a const reference to the same `Shared<T>`, so that subscribers taking a
+ * `const T &` or a `const Shared<T> &` neither copy the payload nor touch the reference count.
+ *
+ * Example:
+ * @code
+ * struct PointCloudReceived {
+ *     using parameters_t = std::tuple<dispatcher::Shared<PointCloud>>;
+ * };
+ *
+ * dispatcher::subscribe<PointCloudReceived>([](const PointCloud &cloud) { ... });
+ * dispatcher::publish<PointCloudReceived>(std::move(cloud)); // moved once into the shared block
+ * @endcode
+ */
+template <typename T>
+class Shared {
+  public:
+    Shared(T value) : payload_(std::make_shared<const T>(std::move(value)))
+    {
+    }
+    Shared(std::shared_ptr<const T> payload) : payload_(std::move(payload))
+    {
+    }
+
+    const T &get() const noexcept
+    {
+        return *payload_;
+    }
+    const T &operator*() const noexcept
+    {
+        return *payload_;
+    }
+    const T *operator->() const noexcept
+    {
+        return payload_.get();
+    }
+    operator const T &() const noexcept
+    {
+        return *payload_;
+    }
+
+  private:
+    std::shared_ptr<const T> payload_;
+};
+
+namespace internal {
+
+// Whether the process registered for expedited membarrier. If it did, the writers of an Rcu domain issue a memory
+// barrier on every thread of the process, and the readers only have to keep the compiler from reordering. Registered
+// on first use, so that programs not using the Rcu domains do not pay for it.
+inline bool AsymmetricFences()
+{
+    static const bool registered = syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+    return registered;
+}
+
+inline void ReaderFence()
+{
+    if (AsymmetricFences()) {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    } else {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+inline void WriterFence()
+{
+    if (AsymmetricFences()) {
+        syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+    } else {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+// Network whose event loop reclaims the objects retired by the Rcu domains that their writers left behind
+struct RcuReclaimer {};
+
+// Calls reclaim with delay from the event loop of RcuReclaimer, once delay elapsed
+inline void DeferReclaim(void (*reclaim)(std::chrono::milliseconds), std::chrono::milliseconds delay);
+
+// Sleepable read-copy-update domain, one per Tag. Read-side sections only store to counters owned by the current
+// thread, without lock nor atomic read-modify-write. A fiber can suspend in a section and end it on another thread, so
+// the counters only make sense summed over every thread: as in SRCU, sections are split in two generations, and a
+// generation is over once as many of its sections ended as started. Memory retired by a writer is reclaimed after
+// two grace periods, that is once both generations were over in turn: right away if no section is in the way,
+// otherwise by the next writer or from the event loop of RcuReclaimer, never by the readers.
+template <typename Tag>
+class Rcu {
+    struct Reader {
+        std::atomic<std::uint64_t> locks[2]{};
+        std::atomic<std::uint64_t> unlocks[2]{};
+        Reader *next = nullptr;
+        Reader *next_free = nullptr;
+    };
+
+    // Handed over to the next thread once the owner exits, only the sums of the counters matter
+    struct LocalReader {
+        LocalReader() : reader(Acquire())
+        {
+        }
+        ~LocalReader()
+        {
+            Release(reader);
+        }
+        Reader *reader;
+    };
+
+    struct Retired {
+        // Number of grace periods elapsed when the object was retired
+        std::uint64_t grace_periods;
+        void *object;
+        void (*destroy)(void *);
+    };
+
+    // The objects still retired at exit are destroyed along with the domain
+    struct RetiredList {
+        ~RetiredList()
+        {
+            for (auto &retired : objects) {
+                retired.destroy(retired.object);
+            }
+            objects.clear();
+        }
+        std::vector<Retired> objects;
+    };
+
+  public:
+    class ReadGuard {
+      public:
+        ReadGuard() : generation_(ReadLock())
+        {
+        }
+        ~ReadGuard()
+        {
+            ReadUnlock(generation_);
+        }
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+
+      private:
+        std::size_t generation_;
+    };
+
+    // Destroys the object with destroy once the sections in flight are over, and the objects retired before whose
+    // grace periods elapsed. The objects still held back by sections are left to the event loop of RcuReclaimer.
+    static void Retire(void *object, void (*destroy)(void *))
+    {
+        if (Collect(object, destroy) && !reclaim_deferred_.exchange(true)) {
+            DeferReclaim(&Reclaim, std::chrono::milliseconds{1});
+        }
+    }
+
+    // Number of grace periods elapsed so far
+    static std::uint64_t GracePeriods()
+    {
+        return grace_periods_.load(std::memory_order_acquire);
+    }
+
+    // Ends the current generation, and then the next one, if their sections are all over. Never waits, returns the
+    // number of grace periods elapsed
+    static std::uint64_t Advance()
+    {
+        std::lock_guard<std::mutex> lock{writer_mutex_};
+        for (int i = 0; i < 2; ++i) {
+            // Orders the publication of the new data before reading the counters
+            WriterFence();
+            auto generation = generation_.load(std::memory_order_relaxed);
+            if (!IsOver(generation ^ 1)) {
+                break;
+            }
+            generation_.store(generation ^ 1, std::memory_order_relaxed);
+            WriterFence();
+            grace_periods_.fetch_add(1, std::memory_order_release);
+        }
+        return grace_periods_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    static std::size_t ReadLock()
+    {
+        auto &reader = *CurrentReader();
+        auto generation = generation_.load(std::memory_order_relaxed);
+        Increment(reader.locks[generation]);
+        // Orders the counter before reading the protected data
+        ReaderFence();
+        return generation;
+    }
+
+    // Not inlined, the compiler would otherwise reuse the address of the thread local of the thread the section started
+    // on, while the fiber may have migrated since
+    __attribute__((noinline)) static void ReadUnlock(std::size_t generation)
+    {
+        ReaderFence();
+        Increment(CurrentReader()->unlocks[generation]);
+    }
+
+    // Adds the object, if any, to the retired ones and destroys those whose grace periods elapsed. Returns whether
+    // objects are left.
+    static bool Collect(void *object, void (*destroy)(void *))
+    {
+        std::vector<Retired> reclaimable;
+        bool left;
+        {
+            std::lock_guard<std::mutex> lock{retired_mutex_};
+            auto &objects = retired_.objects;
+            if (object != nullptr) {
+                objects.push_back(Retired{GracePeriods(), object, destroy});
+            }
+            auto grace_periods = Advance();
+            auto it = std::partition(objects.begin(), objects.end(), [grace_periods](const Retired &retired) {
+                return retired.grace_periods + 2 > grace_periods;
+            });
+            reclaimable.assign(it, objects.end());
+            objects.erase(it, objects.end());
+            left = !objects.empty();
+        }
+        // Outside of the lock, the destructors might retire objects as well
+        for (auto &retired : reclaimable) {
+            retired.destroy(retired.object);
+        }
+        return left;
+    }
+
+    // Run from the event loop of RcuReclaimer, retried less and less often while sections hold objects back
+    static void Reclaim(std::chrono::milliseconds delay)
+    {
+        reclaim_deferred_.store(false);
+        if (Collect(nullptr, nullptr) && !reclaim_deferred_.exchange(true)) {
+            DeferReclaim(&Reclaim, std::min(delay * 2, std::chrono::milliseconds{1000}));
+        }
+    }
+
+    static Reader *CurrentReader()
+    {
+        thread_local LocalReader local;
+        return local.reader;
+    }
+
+    // Only ever written by the owning thread, no read-modify-write needed
+    static void Increment(std::atomic<std::uint64_t> &counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    static bool IsOver(std::size_t generation)
+    {
+        std::uint64_t unlocks = 0;
+        for (auto reader = readers_.load(std::memory_order_acquire); reader != nullptr; reader = reader->next) {
+            unlocks += reader->unlocks[generation].load(std::memory_order_relaxed);
+        }
+        // A section whose end was counted has its start counted as well
+        WriterFence();
+        std::uint64_t locks = 0;
+        for (auto reader = readers_.load(std::memory_order_acquire); reader != nullptr; reader = reader->next) {
+            locks += reader->locks[generation].load(std::memory_order_relaxed);
+        }
+        return locks == unlocks;
+    }
+
+    // Readers are never freed, so that the writers can walk them without lock
+    static Reader *Acquire()
+    {
+        std::lock_guard<std::mutex> lock{registry_mutex_};
+        if (free_readers_ != nullptr) {
+            auto reader = free_readers_;
+            free_readers_ = reader->next_free;
+            return reader;
+        }
+        auto reader = new Reader{};
+        reader->next = readers_.load(std::memory_order_relaxed);
+        readers_.store(reader, std::memory_order_release);
+        return reader;
+    }
+
+    static void Release(Reader *reader)
+    {
+        std::lock_guard<std::mutex> lock{registry_mutex_};
+        reader->next_free = free_readers_;
+        free_readers_ = reader;
+    }
+
+    static inline std::atomic<std::size_t> generation_{0};
+    static inline std::atomic<std::uint64_t> grace_periods_{0};
+    static inline std::atomic<Reader *> readers_{nullptr};
+    static inline Reader *free_readers_ = nullptr;
+    static inline std::mutex registry_mutex_;
+    static inline std::mutex writer_mutex_;
+    // Locked before writer_mutex_
+    static inline std::mutex retired_mutex_;
+    static inline RetiredList retired_;
+    // Whether a reclaim is pending on the event loop of RcuReclaimer
+    static inline std::atomic<bool> reclaim_deferred_{false};
+};
+
+// Pointer to an object replaced read-copy-update style, protected by the Rcu domain of Tag. Readers in a read-side
+// section keep using the object they loaded, a replaced object is destroyed by the domain once they all left.
+template <typename Tag, typename T>
+class RcuPointer {
+    using Rcu = internal::Rcu<Tag>;
+
+  public:
+    constexpr RcuPointer() = default;
+    RcuPointer(const RcuPointer &) = delete;
+    RcuPointer &operator=(const RcuPointer &) = delete;
+
+    ~RcuPointer()
+    {
+        delete pointer_.load(std::memory_order_relaxed);
+    }
+
+    // Must be called in a read-side section, which the returned object outlives
+    T *Get() const
+    {
+        return pointer_.load(std::memory_order_acquire);
+    }
+
+    // Publishes the new object, and returns the previous one, which must be retired
+    T *Exchange(T *pointer)
+    {
+        return pointer_.exchange(pointer, std::memory_order_acq_rel);
+    }
+
+    // Destroys the previous object once the sections in flight are over
+    void Retire(T *previous)
+    {
+        Rcu::Retire(previous, [](void *object) { delete static_cast<T *>(object); });
+    }
+
+    void Replace(T *pointer)
+    {
+        Retire(Exchange(pointer));
+    }
+
+  private:
+    std::atomic<T *> pointer_{nullptr};
+};
+
+// Type of a parameter as received by the subscribers: shared payloads are handed out by const reference
+template <typename Parameter>
+struct SubscriberParameter {
+    using type = Parameter;
+};
+
+template <typename T>
+struct SubscriberParameter<Shared<T>> {
+    using type = const Shared<T> &;
+};
+
+template <typename Parameter>
+using subscriber_parameter_t = typename SubscriberParameter<Parameter>::type;
+
+// Whether each subscriber receives its own copy of the parameter: by-value parameters other than shared payloads and
+// small trivially copyable types
+template <typename Parameter>
+struct is_copied_per_subscriber
+    : std::integral_constant<bool, !std::is_reference<Parameter>::value &&
+                                       !std::is_reference<subscriber_parameter_t<Parameter>>::value &&
+                                       !(std::is_trivially_copyable<Parameter>::value &&
+                                         sizeof(Parameter) <= 2 * sizeof(void *))> {};
+
+template <typename Parameters>
+struct has_parameter_copied_per_subscriber;
+
+template <typename... Parameters>
+struct has_parameter_copied_per_subscriber<std::tuple<Parameters...>>
+    : std::disjunction<is_copied_per_subscriber<Parameters>...> {};
+
+// Subscribers of an event. Emitting loops over an immutable snapshot of the subscribers, without lock nor reference
+// counting. Subscribing and disconnecting publish a modified copy, and the previous snapshot, with the callables of the
+// disconnected slots, is destroyed once the emissions in flight are over.
+template <typename... Parameters>
+class SubscriberList<void(Parameters...)> {
+    struct Slot : SubscriberSlot {
+        template <typename Callable>
+        Slot(SubscriberList &list, Callable &&callable) : list(list), callback(std::forward<Callable>(callable))
+        {
+        }
+
+        void Disconnect() override
+        {
+            list.Remove(this);
+        }
+
+        SubscriberList &list;
+        InplaceFunction<void(subscriber_parameter_t<Parameters>...)> callback;
+    };
+
+    using Snapshot = std::vector<std::shared_ptr<Slot>>;
+
+  public:
+    SubscriberList() = default;
+    SubscriberList(const SubscriberList &) = delete;
+    SubscriberList &operator=(const SubscriberList &) = delete;
+
+    template <typename Callable>
+    Connection Connect(Callable &&callable)
+    {
+        auto slot = std::make_shared<Slot>(*this, std::forward<Callable>(callable));
+        Snapshot *previous = nullptr;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            auto current = subscribers_.Get();
+            auto next = new Snapshot();
+            next->reserve((current ? current->size() : 0) + 1);
+            if (current) {
+                next->assign(current->begin(), current->end());
+            }
+            next->push_back(slot);
+            previous = subscribers_.Exchange(next);
+        }
+        subscribers_.Retire(previous);
+        return Connection{slot};
+    }
+
+    bool Empty() const
+    {
+        return subscribers_.Get() == nullptr;
+    }
+
+    void operator()(Parameters... parameters) const
+    {
+        typename Rcu<SubscriberList>::ReadGuard guard;
+        auto subscribers = subscribers_.Get();
+        if (subscribers == nullptr) {
+            return;
+        }
+        for (const auto &slot : *subscribers) {
+            // Skips the slots disconnected since the snapshot was taken, possibly by an earlier subscriber
+            if (slot->connected.load(std::memory_order_relaxed)) {
+                slot->callback(
+                    static_cast<std::conditional_t<std::is_rvalue_reference<Parameters>::value, Parameters,
+                                                   Parameters &>>(parameters)...);
+            }
+        }
+    }
+
+  private:
+    void Remove(Slot *slot)
+    {
+        Snapshot *previous = nullptr;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (!slot->connected.load(std::memory_order_relaxed)) {
+                return;
+            }
+            slot->connected.store(false, std::memory_order_release);
+            auto current = subscribers_.Get();
+            Snapshot *next = nullptr;
+            if (current->size() > 1) {
+                next = new Snapshot();
+                next->reserve(current->size() - 1);
+                std::copy_if(current->begin(), current->end(), std::back_inserter(*next),
+                             [slot](const auto &other) { return other.get() != slot; });
+            }
+            previous = subscribers_.Exchange(next);
+        }
+        subscribers_.Retire(previous);
+    }
+
+    RcuPointer<SubscriberList, Snapshot> subscribers_;
+    std::mutex mutex_;
+};
+
+// Subscribers of a keyed event, indexed by key so that a publish only reaches the subscribers of its key. The list of a
+// key is created by its first subscription and kept until exit, and the index is replaced read-copy-update style when a
+// key is added, so that looking a key up takes no lock.
+template <typename Key, typename Signal>
+class KeyedSubscribers {
+    using Index = std::unordered_map<Key, Signal *>;
+
+  public:
+    KeyedSubscribers() = default;
+    KeyedSubscribers(const KeyedSubscribers &) = delete;
+    KeyedSubscribers &operator=(const KeyedSubscribers &) = delete;
+
+    Signal &GetOrCreate(const Key &key)
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        auto index = index_.Get();
+        if (index != nullptr) {
+            auto it = index->find(key);
+            if (it != index->end()) {
+                return *it->second;
+            }
+        }
+        auto &signal = signals_.emplace_back();
+        auto next = index != nullptr ? new Index(*index) : new Index();
+        next->emplace(key, &signal);
+        index_.Replace(next);
+        return signal;
+    }
+
+    // The subscribers of the key, if any ever subscribed to it
+    Signal *Find(const Key &key) const
+    {
+        typename Rcu<KeyedSubscribers>::ReadGuard guard;
+        auto index = index_.Get();
+        if (index == nullptr) {
+            return nullptr;
+        }
+        auto it = index->find(key);
+        return it != index->end() ? it->second : nullptr;
+    }
+
+  private:
+    RcuPointer<KeyedSubscribers, Index> index_;
+    std::deque<Signal> signals_;
+    std::mutex mutex_;
+};
+
+// Handler attached to a function signature. Attaching publishes a new copy, the calls in flight finish on the previous
+// one. Constant initialized, so that accessing it does not go through the guard of a function-local static
+template <typename FuncSignature, typename func_type>
+constinit RcuPointer<FuncSignature, func_type> function_storage{};
+
+template <typename FuncSignature, typename func_type>
+RcuPointer<FuncSignature, func_type> &GetFunction()
+{
+    return function_storage<FuncSignature, func_type>;
+}
+
+template <typename FuncSignature>
+struct FunctionDispatcher {
+    template <typename Callable>
+    static void attach(Callable &&callable)
+    {
+        static_assert(!has_static_handler<FuncSignature>::value, "The function signature is bound at compile time");
+        GetFunction<FuncSignature, func_type>().Replace(new func_type(std::forward<Callable>(callable)));
+    }
+
+    static void detach()
+    {
+        static_assert(!has_static_handler<FuncSignature>::value, "The function signature is bound at compile time");
+        GetFunction<FuncSignature, func_type>().Replace(nullptr);
+    }
+
+    template <typename... Args>
+    static auto call(Args &&...args)
+    {
+        if constexpr (has_static_handler<FuncSignature>::value) {
+            using static_return_t =
+                typename ReturnTypeFromCallable<decltype(StaticHandler<FuncSignature>::function), args_t>::type;
+            static_assert(std::is_same<return_t, static_return_t>::value,
+                          "The return values of the function is not matching the function signature");
+            return StaticHandler<FuncSignature>::function(std::forward<Args>(args)...);
+        } else {
+            typename Rcu<FuncSignature>::ReadGuard guard;
+            auto handler = GetFunction<FuncSignature, func_type>().Get();
+            if (handler == nullptr || !*handler) {
+                throw NoHandler<FuncSignature>{};
+            }
+            return (*handler)(std::forward<Args>(args)...);
+        }
+    }
+
+    using return_t = typename return_t_or_default<FuncSignature, has_return_t<FuncSignature>::value>::type;
+    using args_t = typename args_t_or_default<FuncSignature, has_args_t<FuncSignature>::value>::type;
+
+    using func_type =
+        typename FunctionFromTuple<return_t, args_t, handler_storage_size_or_default<FuncSignature>::value>::type;
+
+    // Same as call, but a missing handler is reported in the result instead of by throwing
+    template <typename... Args>
+    static CallResult<return_t> try_call(Args &&...args)
+    {
+        if constexpr (has_static_handler<FuncSignature>::value) {
+            return ResultOf([&]() -> return_t { return call(std::forward<Args>(args)...); });
+        } else {
+            typename Rcu<FuncSignature>::ReadGuard guard;
+            auto handler = GetFunction<FuncSignature, func_type>().Get();
+            if (handler == nullptr || !*handler) {
+                return CallError::NoHandler;
+            }
+            return ResultOf([&]() -> return_t { return (*handler)(std::forward<Args>(args)...); });
+        }
+    }
+
+    template <typename Callable>
+    static CallResult<return_t> ResultOf(Callable &&callable)
+    {
+        if constexpr (std::is_void<return_t>::value) {
+            callable();
+            return {};
+        } else {
+            return callable();
+        }
+    }
+};
+
+// Memory region reserved up front, out of which fiber stacks of a single size are carved.
+// The region is backed by explicitly reserved huge pages when the system has some, and otherwise asks for transparent
+// huge pages. Packing the stacks in huge pages reduces the TLB misses when switching between many fibers. Stacks of the
+// arena have no guard page, since protecting a page would split the huge page containing it.
+class StackArena {
+  public:
+    static constexpr std::size_t kHugePageSize = 2 * 1024 * 1024;
+
+    StackArena(std::size_t arena_size, std::size_t stack_size) : stack_size_(stack_size)
+    {
+        size_ = (arena_size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+        if (size_ == 0) {
+            return;
+        }
+#ifdef MAP_HUGETLB
+        void *mapping =
+            ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mapping != MAP_FAILED) {
+            begin_ = static_cast<char *>(mapping);
+            return;
+        }
+#endif
+        // Over-reserve to align the region on a huge page, which transparent huge pages require
+        void *reservation =
+            ::mmap(nullptr, size_ + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (reservation == MAP_FAILED) {
+            size_ = 0;
+            return;
+        }
+        auto address = reinterpret_cast<std::uintptr_t>(reservation);
+        auto aligned = (address + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+        if (aligned != address) {
+            ::munmap(reservation, aligned - address);
+        }
+        ::munmap(reinterpret_cast<char *>(aligned) + size_, kHugePageSize - (aligned - address));
+        begin_ = reinterpret_cast<char *>(aligned);
+#ifdef MADV_HUGEPAGE
+        ::madvise(begin_, size_, MADV_HUGEPAGE);
+#endif
+    }
+    ~StackArena()
+    {
+        if (begin_) {
+            ::munmap(begin_, size_);
+        }
+    }
+
+    StackArena(const StackArena &) = delete;
+    StackArena(StackArena &&) = delete;
+    StackArena &operator=(const StackArena &) = delete;
+    StackArena &operator=(StackArena &&) = delete;
+
+    // Returns the lowest address of a stack, or nullptr once the arena is exhausted
+    void *Allocate()
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (free_list_) {
+            auto block = free_list_;
+            free_list_ = block->next;
+            return block;
+        }
+        if (used_ + stack_size_ > size_) {
+            return nullptr;
+        }
+        auto block = begin_ + used_;
+        used_ += stack_size_;
+        return block;
+    }
+
+    void Free(void *block)
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        free_list_ = new (block) FreeListNode{free_list_};
+    }
+
+    bool Contains(const void *block) const
+    {
+        auto address = static_cast<const char *>(block);
+        return begin_ && address >= begin_ && address < begin_ + size_;
+    }
+
+    std::size_t GetSize() const
+    {
+        return size_;
+    }
+
+  private:
+    struct FreeListNode {
+        FreeListNode *next;
+    };
+
+    const std::size_t stack_size_;
+    std::size_t size_;
+    char *begin_ = nullptr;
+    std::mutex mutex_;
+    std::size_t used_ = 0;
+    FreeListNode *free_list_ = nullptr;
+};
+
+// Cache of fiber stacks of a single size, shared by the worker threads of an EventLoop.
+// Stacks are carved from the arena when there is one and it is not exhausted. Otherwise they are mapped with a guard
+// page below them, so that an overflow crashes instead of corrupting memory. Their size is rounded up to whole pages.
+// Every attached thread owns a magazine of stacks, which it uses without locking. An empty magazine is refilled with
+// half a magazine from the depot, a full one gives half of its stacks back to it. The depot is an intrusive free list:
+// the link to the next free stack is stored in the stack itself. When it holds more stacks than the high watermark,
+// the depot releases memory until it is back to the low watermark, which is also the amount of stacks allocated up
+// front.
+class StackCache {
+  public:
+    StackCache(std::size_t stack_size,
+               std::size_t low_watermark,
+               std::size_t high_watermark,
+               std::size_t arena_size = 0)
+        : page_size_(boost::context::stack_traits::page_size()),
+          stack_size_(UsableStackSize(stack_size)),
+          low_watermark_(low_watermark),
+          high_watermark_(std::max(low_watermark, high_watermark)),
+          arena_(arena_size, stack_size_)
+    {
+        for (std::size_t i = 0; i < low_watermark_; ++i) {
+            PushToDepot(AllocateBlock());
+        }
+    }
+    ~StackCache()
+    {
+        for (auto &magazine : magazines_) {
+            while (magazine->count > 0) {
+                FreeBlock(magazine->Pop());
+            }
+        }
+        while (depot_) {
+            FreeBlock(PopFromDepot());
+        }
+    }
+
+    StackCache(const StackCache &) = delete;
+    StackCache(StackCache &&) = delete;
+    StackCache &operator=(const StackCache &) = delete;
+    StackCache &operator=(StackCache &&) = delete;
+
+    // Give the calling thread its own magazine. A thread can only be attached to a single cache at a time.
+    void AttachThread()
+    {
+        std::lock_guard<std::mutex> lock{depot_mutex_};
+        magazines_.push_back(std::make_unique<Magazine>(this));
+        CurrentMagazine() = magazines_.back().get();
+    }
+
+    // Hand the stacks of the calling thread over to the depot. Stacks released later by this thread, e.g. by its fiber
+    // scheduler when the thread exits, go directly to the depot.
+    void DetachThread()
+    {
+        auto magazine = LocalMagazine();
+        if (!magazine) {
+            return;
+        }
+        CurrentMagazine() = nullptr;
+        std::lock_guard<std::mutex> lock{depot_mutex_};
+        while (magazine->count > 0) {
+            PushToDepot(magazine->Pop());
+        }
+        Trim();
+    }
+
+    void *Allocate()
+    {
+        if (auto magazine = LocalMagazine()) {
+            if (magazine->count == 0) {
+                std::lock_guard<std::mutex> lock{depot_mutex_};
+                while (depot_ && magazine->count < kMagazineSize / 2) {
+                    magazine->Push(PopFromDepot());
+                }
+            }
+            if (magazine->count > 0) {
+                Increment(magazine->hits);
+                return magazine->Pop();
+            }
+            Increment(magazine->misses);
+            return AllocateBlock();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{depot_mutex_};
+            if (depot_) {
+                ++depot_hits_;
+                return PopFromDepot();
+            }
+            ++depot_misses_;
+        }
+        return AllocateBlock();
+    }
+
+    void Free(void *block)
+    {
+        if (auto magazine = LocalMagazine()) {
+            if (magazine->count == kMagazineSize) {
+                std::lock_guard<std::mutex> lock{depot_mutex_};
+                while (magazine->count > kMagazineSize / 2) {
+                    PushToDepot(magazine->Pop());
+                }
+                Trim();
+            }
+            magazine->Push(block);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock{depot_mutex_};
+        PushToDepot(block);
+        Trim();
+    }
+
+    std::size_t GetStackSize() const
+    {
+        return stack_size_;
+    }
+
+    // Size of the stacks handed out for the requested size
+    static std::size_t UsableStackSize(std::size_t stack_size)
+    {
+        auto page_size = boost::context::stack_traits::page_size();
+        stack_size = std::max(stack_size, boost::context::stack_traits::minimum_size());
+        return (stack_size + page_size - 1) / page_size * page_size;
+    }
+
+    StackCacheStats GetStats()
+    {
+        std::lock_guard<std::mutex> lock{depot_mutex_};
+        StackCacheStats stats;
+        stats.hits = depot_hits_;
+        stats.misses = depot_misses_;
+        stats.blocks_held = depot_count_;
+        for (const auto &magazine : magazines_) {
+            stats.hits += magazine->hits.load(std::memory_order_relaxed);
+            stats.misses += magazine->misses.load(std::memory_order_relaxed);
+            stats.blocks_held += magazine->count.load(std::memory_order_relaxed);
+        }
+        stats.bytes_held = stats.blocks_held * stack_size_;
+        stats.arena_bytes = arena_.GetSize();
+        return stats;
+    }
+
+  private:
+    static constexpr std::size_t kMagazineSize = 16;
+
+    struct FreeListNode {
+        FreeListNode *next;
+    };
+
+    // Only modified by the thread owning it, the counters are atomic so that the statistics can be read concurrently
+    struct Magazine {
+        explicit Magazine(StackCache *_owner) : owner(_owner)
+        {
+        }
+
+        void Push(void *block)
+        {
+            auto size = count.load(std::memory_order_relaxed);
+            blocks[size] = block;
+            count.store(size + 1, std::memory_order_relaxed);
+        }
+
+        void *Pop()
+        {
+            auto size = count.load(std::memory_order_relaxed) - 1;
+            count.store(size, std::memory_order_relaxed);
+            return blocks[size];
+        }
+
+        StackCache *owner;
+        void *blocks[kMagazineSize];
+        std::atomic<std::size_t> count{0};
+        std::atomic<std::size_t> hits{0};
+        std::atomic<std::size_t> misses{0};
+    };
+
+    static Magazine *&CurrentMagazine()
+    {
+        thread_local Magazine *magazine = nullptr;
+        return magazine;
+    }
+
+    Magazine *LocalMagazine()
+    {
+        auto magazine = CurrentMagazine();
+        return magazine && magazine->owner == this ? magazine : nullptr;
+    }
+
+    static void Increment(std::atomic<std::size_t> &counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Returns the lowest usable address of the stack
+    void *AllocateBlock()
+    {
+        if (auto block = arena_.Allocate()) {
+            return block;
+        }
+        void *mapping =
+            ::mmap(nullptr, stack_size_ + page_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        // Without its guard page, an overflow would silently corrupt the memory below the stack
+        if (::mprotect(mapping, page_size_, PROT_NONE) != 0) {
+            ::munmap(mapping, stack_size_ + page_size_);
+            throw std::bad_alloc();
+        }
+        return static_cast<char *>(mapping) + page_size_;
+    }
+
+    void FreeBlock(void *block)
+    {
+        if (arena_.Contains(block)) {
+            arena_.Free(block);
+            return;
+        }
+        ::munmap(static_cast<char *>(block) - page_size_, stack_size_ + page_size_);
+    }
+
+    // The depot functions must be called with depot_mutex_ held
+    void PushToDepot(void *block)
+    {
+        depot_ = new (block) FreeListNode{depot_};
+        ++depot_count_;
+    }
+
+    void *PopFromDepot()
+    {
+        auto block = depot_;
+        depot_ = block->next;
+        --depot_count_;
+        return block;
+    }
+
+    void Trim()
+    {
+        if (depot_count_ <= high_watermark_) {
+            return;
+        }
+        while (depot_count_ > low_watermark_) {
+            FreeBlock(PopFromDepot());
+        }
+    }
+
+    const std::size_t page_size_;
+    const std::size_t stack_size_;
+    const std::size_t low_watermark_;
+    const std::size_t high_watermark_;
+    std::mutex depot_mutex_;
+    FreeListNode *depot_ = nullptr;
+    std::size_t depot_count_ = 0;
+    std::size_t depot_hits_ = 0;
+    std::size_t depot_misses_ = 0;
+    std::vector<std::unique_ptr<Magazine>> magazines_;
+    StackArena arena_;
+};
+
+// Opt-in measurement of the stack usage of the fibers of an EventLoop.
+// Stacks are painted with a pattern when they are allocated, the lowest overwritten byte gives their high-water mark.
+// Every stack is measured when it is released, and never painted again while in use. The pooled fibers of a profiled
+// network run a single task each, whose signature, when known, is measured along with the stack.
+class StackProfiler {
+  public:
+    static void Paint(void *begin, std::size_t size)
+    {
+        std::memset(begin, kPattern, size);
+    }
+
+    // Bytes used at the top of the stack starting at low
+    static std::size_t Measure(const void *low, std::size_t size)
+    {
+        auto bytes = static_cast<const unsigned char *>(low);
+        std::size_t untouched = 0;
+        while (untouched < size && bytes[untouched] == kPattern) {
+            ++untouched;
+        }
+        return size - untouched;
+    }
+
+    // Called when the stack is released, signature is null if the fiber did not run a task of a known signature
+    void MeasureStack(const boost::context::stack_context &stack, const char *signature)
+    {
+        auto used = Measure(static_cast<char *>(stack.sp) - stack.size, stack.size);
+        std::lock_guard<std::mutex> lock{mutex_};
+        Record(profile_.network, stack.size, used);
+        if (signature) {
+            Record(profile_.signatures[signature], stack.size, used);
+        }
+    }
+
+    StackProfile GetProfile()
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        return profile_;
+    }
+
+  private:
+    static constexpr unsigned char kPattern = 0xA5;
+
+    static void Record(StackUsage &usage, std::size_t stack_size, std::size_t used)
+    {
+        usage.stack_size = std::max(usage.stack_size, stack_size);
+        usage.high_water_mark = std::max(usage.high_water_mark, used);
+        ++usage.samples;
+    }
+
+    std::mutex mutex_;
+    StackProfile profile_;
+};
+
+// Signature of the task that just returned on a fiber, set by the tasks wrapped by WithStackProfiling
+struct CompletedTask {
+    boost::fibers::context *fiber = nullptr;
+    const char *signature = nullptr;
+};
+
+inline CompletedTask &LastCompletedTask()
+{
+    thread_local CompletedTask completed_task;
+    return completed_task;
+}
+
+// When profiling, stacks are painted on allocation and measured on deallocation, along with the signature the fiber
+// reported through signature.
+class CustomStackAllocator {
+  public:
+    explicit CustomStackAllocator(StackCache &stack_cache,
+                                  StackProfiler *profiler = nullptr,
+                                  std::shared_ptr<const char *> signature = nullptr)
+        : stack_cache_(stack_cache), profiler_(profiler), signature_(std::move(signature))
+    {
+    }
+
+    boost::context::stack_context allocate()
+    {
+        boost::context::stack_context sctx;
+        sctx.size = stack_cache_.GetStackSize();
+        sctx.sp = static_cast<char *>(stack_cache_.Allocate()) + sctx.size;
+        if (profiler_) {
+            StackProfiler::Paint(static_cast<char *>(sctx.sp) - sctx.size, sctx.size);
+        }
+        return sctx;
+    }
+
+    void deallocate(boost::context::stack_context &sctx)
+    {
+        BOOST_ASSERT(sctx.sp);
+
+        if (profiler_) {
+            profiler_->MeasureStack(sctx, signature_ ? *signature_ : nullptr);
+        }
+        void *vp = static_cast<char *>(sctx.sp) - sctx.size;
+        stack_cache_.Free(vp);
+    }
+
+  private:
+    StackCache &stack_cache_;
+    StackProfiler *profiler_;
+    std::shared_ptr<const char *> signature_;
+};
+
+inline bool &RunningInlineTask()
+{
+    thread_local bool running_inline_task = false;
+    return running_inline_task;
+}
+
+enum class Execution {
+    Fiber,  // The task runs in its own fiber, and is allowed to block
+    Inline  // The task runs directly on the event loop thread, and must not block
+};
+
+// FIFO queues of items of each priority, served highest priority first. A non-empty lane passed over
+// starvation_limit times in a row is served next, so that a busy lane cannot starve the lower ones. A limit of 0
+// serves the lanes strictly by priority. Not thread-safe.
+template <typename T>
+class PriorityLanes {
+  public:
+    explicit PriorityLanes(std::size_t starvation_limit) : starvation_limit_(starvation_limit)
+    {
+    }
+
+    template <typename... Args>
+    void Push(Priority priority, Args &&...args)
+    {
+        lanes_[static_cast<std::size_t>(priority)].emplace_back(std::forward<Args>(args)...);
+    }
+
+    bool Empty() const
+    {
+        return std::all_of(lanes_.begin(), lanes_.end(), [](const auto &lane) { return lane.empty(); });
+    }
+
+    // Must not be called when empty
+    T Pop()
+    {
+        std::size_t served = kPriorityCount;
+        for (std::size_t lane = kPriorityCount; lane-- > 0;) {
+            if (lanes_[lane].empty()) {
+                continue;
+            }
+            if (served == kPriorityCount) {
+                served = lane;
+            } else if (starvation_limit_ > 0 && passed_over_[lane] >= starvation_limit_) {
+                served = lane;
+                break;
+            }
+        }
+        for (std::size_t lane = 0; lane < kPriorityCount; ++lane) {
+            passed_over_[lane] = lane == served || lanes_[lane].empty() ? 0 : passed_over_[lane] + 1;
+        }
+        auto item = std::move(lanes_[served].front());
+        lanes_[served].pop_front();
+        return item;
+    }
+
+    std::size_t GetStarvationLimit() const
+    {
+        return starvation_limit_;
+    }
+
+  private:
+    std::array<std::deque<T>, kPriorityCount> lanes_;
+    std::array<std::size_t, kPriorityCount> passed_over_{};
+    const std::size_t starvation_limit_;
+};
+
+// Time between the posting of the tasks of a network and the start of their execution, per priority. Recorded from
+// every worker thread.
+class QueueLatencyRecorder {
+  public:
+    void Record(Priority priority, std::chrono::steady_clock::time_point queued_at)
+    {
+        auto latency =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - queued_at).count();
+        auto &lane = lanes_[static_cast<std::size_t>(priority)];
+        lane.samples.fetch_add(1, std::memory_order_relaxed);
+        lane.total.fetch_add(latency, std::memory_order_relaxed);
+        auto max = lane.max.load(std::memory_order_relaxed);
+        while (latency > max && !lane.max.compare_exchange_weak(max, latency, std::memory_order_relaxed)) {
+        }
+    }
+
+    QueueLatencyStats GetStats() const
+    {
+        QueueLatencyStats stats;
+        for (std::size_t i = 0; i < kPriorityCount; ++i) {
+            stats.priorities[i].samples = lanes_[i].samples.load(std::memory_order_relaxed);
+            stats.priorities[i].total = std::chrono::nanoseconds{lanes_[i].total.load(std::memory_order_relaxed)};
+            stats.priorities[i].max = std::chrono::nanoseconds{lanes_[i].max.load(std::memory_order_relaxed)};
+        }
+        return stats;
+    }
+
+  private:
+    struct Lane {
+        std::atomic<std::size_t> samples{0};
+        std::atomic<std::int64_t> total{0};
+        std::atomic<std::int64_t> max{0};
+    };
+
+    std::array<Lane, kPriorityCount> lanes_;
+};
+
+// Time at which a task is posted, only taken when the network measures its queue latency
+template <typename Network>
+std::chrono::steady_clock::time_point QueuedAt()
+{
+    if constexpr (measures_queue_latency<Network>::value) {
+        return std::chrono::steady_clock::now();
+    } else {
+        return {};
+    }
+}
+
+// Priority of the task a fiber of an EventLoop is running. It orders the fiber in the shared ready queue whenever the
+// fiber is resumed.
+class FiberPriority : public boost::fibers::fiber_properties {
+  public:
+    explicit FiberPriority(boost::fibers::context *ctx) : fiber_properties(ctx)
+    {
+    }
+
+    Priority priority = Priority::Normal;
+};
+
+// Only called from the fibers of an EventLoop, whose scheduler gives them a FiberPriority
+inline void SetFiberPriority(Priority priority)
+{
+    if (auto properties = boost::fibers::context::active()->get_properties()) {
+        static_cast<FiberPriority *>(properties)->priority = priority;
+    }
+}
+
+class SharedWorkScheduler;
+
+// Ready queue shared by all the worker threads of an EventLoop. Fibers pushed here can be resumed by any of them,
+// highest priority first.
+struct SharedReadyQueue {
+    explicit SharedReadyQueue(std::size_t starvation_limit) : contexts(starvation_limit)
+    {
+    }
+
+    std::mutex mutex;
+    PriorityLanes<boost::fibers::context *> contexts;
+    // Schedulers sleeping because they ran out of work, one of them is woken up for every fiber pushed
+    std::vector<SharedWorkScheduler *> idle_schedulers;
+    // Every scheduler of the event loop, so that they can all be woken up when it stops
+    std::vector<SharedWorkScheduler *> schedulers;
+    // Scheduler whose thread runs the io_context, none while it runs fibers. Set under the mutex, except when it steps
+    // down or a scheduler takes the vacant lead.
+    std::atomic<SharedWorkScheduler *> leader{nullptr};
+    // Tasks posted through the io_context or the ingress queue of the event loop, and not run or handed over to a fiber
+    // pool yet. Pooled fibers yield between tasks while there are some, so that they are not delayed by a busy pool.
+    std::atomic<std::size_t> pending_posts{0};
+};
+
+// Fiber scheduling algorithm installed on every worker thread of an EventLoop.
+// Pinned contexts (main and dispatcher fibers) stay on their thread, every other fiber goes through the shared ready
+// queue so that the load is spread across the worker threads of the same network.
+//
+// Every worker thread runs the io_context, but one at a time: the leader polls it between fibers and blocks in it once
+// out of work, while the other worker threads sleep on their condition variable. The leader steps down while it runs
+// fibers, handing the io_context over to a sleeping worker thread if there is one, so that a busy thread does not delay
+// the handlers. As only the leader is in the io_context, a handler posted to it wakes up that very thread, and notify()
+// wakes up the thread of its scheduler whether it sleeps in the io_context or on its condition variable.
+//
+// The dispatcher fiber does not sleep in suspend_until, it records when the next sleeping fiber is due and hands over to
+// the main fiber, which then sleeps in Sleep().
+class SharedWorkScheduler : public boost::fibers::algo::algorithm_with_properties<FiberPriority> {
+  public:
+    SharedWorkScheduler(SharedReadyQueue &shared_queue, boost::asio::io_context &io_context)
+        : shared_queue_(shared_queue), io_context_(io_context), wake_up_timer_(io_context)
+    {
+        std::lock_guard<std::mutex> lock{shared_queue_.mutex};
+        shared_queue_.schedulers.push_back(this);
+    }
+
+    ~SharedWorkScheduler() override
+    {
+        std::lock_guard<std::mutex> lock{shared_queue_.mutex};
+        auto &schedulers = shared_queue_.schedulers;
+        schedulers.erase(std::remove(schedulers.begin(), schedulers.end(), this), schedulers.end());
+    }
+
+    SharedWorkScheduler(const SharedWorkScheduler &) = delete;
+    SharedWorkScheduler(SharedWorkScheduler &&) = delete;
+    SharedWorkScheduler &operator=(const SharedWorkScheduler &) = delete;
+    SharedWorkScheduler &operator=(SharedWorkScheduler &&) = delete;
+
+    void awakened(boost::fibers::context *ctx, FiberPriority &properties) noexcept override
+    {
+        if (ctx->is_context(boost::fibers::type::pinned_context)) {
+            ctx->ready_link(local_queue_);
+            return;
+        }
+        ctx->detach();
+        SharedWorkScheduler *idle_scheduler = nullptr;
+        {
+            std::lock_guard<std::mutex> lock{shared_queue_.mutex};
+            shared_queue_.contexts.Push(properties.priority, ctx);
+            if (!shared_queue_.idle_schedulers.empty()) {
+                idle_scheduler = shared_queue_.idle_schedulers.back();
+                shared_queue_.idle_schedulers.pop_back();
+            }
+        }
+        if (idle_scheduler) {
+            idle_scheduler->notify();
+        }
+    }
+
+    boost::fibers::context *pick_next() noexcept override
+    {
+        BOOST_ASSERT_MSG(!RunningInlineTask(), "A non-suspending task tried to block the event loop");
+        // Alternate between the local and shared queues so that the main fiber, which polls the io_context, is not
+        // starved when the shared queue is busy
+        prefer_local_ = !prefer_local_;
+        if (prefer_local_ && !local_queue_.empty()) {
+            return pop_local();
+        }
+        // While the main fiber is parked, only let the dispatcher reach suspend_until
+        if (!parked_) {
+            std::unique_lock<std::mutex> lock{shared_queue_.mutex};
+            if (!shared_queue_.contexts.Empty()) {
+                auto ctx = shared_queue_.contexts.Pop();
+                lock.unlock();
+                boost::fibers::context::active()->attach(ctx);
+                return ctx;
+            }
+        }
+        if (!local_queue_.empty()) {
+            return pop_local();
+        }
+        return nullptr;
+    }
+
+    bool has_ready_fibers() const noexcept override
+    {
+        for (const auto &ctx : local_queue_) {
+            if (!ctx.is_context(boost::fibers::type::dispatcher_context)) {
+                return true;
+            }
+        }
+        std::lock_guard<std::mutex> lock{shared_queue_.mutex};
+        return !shared_queue_.contexts.Empty();
+    }
+
+    void suspend_until(const std::chrono::steady_clock::time_point &time_point) noexcept override
+    {
+        // Once the main fiber has returned, the fibers left on this thread are waited for here
+        if (retired_) {
+            WaitForNotification(time_point);
+            return;
+        }
+        sleep_until_ = time_point;
+        parked_ = false;
+        park_condition_.notify_one();
+    }
+
+    void notify() noexcept override
+    {
+        bool in_io_context;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            notified_ = true;
+            in_io_context = in_io_context_;
+        }
+        if (in_io_context) {
+            boost::asio::post(io_context_, [] {});
+        } else {
+            condition_.notify_all();
+        }
+    }
+
+    // Called from the main fiber. Returns true if this thread is the leader, taking the lead if it is vacant.
+    bool Lead()
+    {
+        auto &leader = shared_queue_.leader;
+        SharedWorkScheduler *vacant = nullptr;
+        return leader.load() == this || leader.compare_exchange_strong(vacant, this);
+    }
+
+    // Called from the main fiber of the leader before it runs fibers. The lead is handed over to a sleeping worker
+    // thread, or left vacant until a worker thread runs out of fibers.
+    void StepDown()
+    {
+        if (shared_queue_.leader.load() != this) {
+            return;
+        }
+        SharedWorkScheduler *follower = nullptr;
+        {
+            std::lock_guard<std::mutex> lock{shared_queue_.mutex};
+            if (!shared_queue_.idle_schedulers.empty()) {
+                follower = shared_queue_.idle_schedulers.back();
+                shared_queue_.idle_schedulers.pop_back();
+            }
+            shared_queue_.leader = follower;
+        }
+        if (follower) {
+            follower->notify();
+        }
+    }
+
+    // Called from the main fiber. Returns once the dispatcher ran out of ready fibers and recorded when the sleeping
+    // ones are due, so that the main fiber can put the thread to sleep.
+    void WaitForDispatcher()
+    {
+        std::unique_lock<boost::fibers::mutex> lock{park_mutex_};
+        parked_ = true;
+        park_condition_.wait(lock, [this] { return !parked_; });
+    }
+
+    // Called from the main fiber after WaitForDispatcher. The leader blocks in the io_context, with a timer armed for
+    // the next sleeping fiber, the other worker threads on their condition variable. Returns once notified, or once the
+    // next sleeping fiber is due.
+    void Sleep()
+    {
+        if (!EnterIdle()) {
+            return;
+        }
+        if (Lead()) {
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                in_io_context_ = !std::exchange(notified_, false);
+            }
+            if (in_io_context_) {
+                if (sleep_until_ != std::chrono::steady_clock::time_point::max()) {
+                    wake_up_timer_.expires_at(sleep_until_);
+                    wake_up_timer_.async_wait([](const boost::system::error_code &) {});
+                }
+                io_context_.run_one();
+                std::lock_guard<std::mutex> lock{mutex_};
+                in_io_context_ = false;
+                notified_ = false;
+            }
+        } else {
+            WaitForNotification(sleep_until_);
+        }
+        LeaveIdle();
+    }
+
+    // Called from the main fiber once it stops driving the thread
+    void Retire()
+    {
+        retired_ = true;
+        SharedWorkScheduler *self = this;
+        shared_queue_.leader.compare_exchange_strong(self, nullptr);
+    }
+
+    // Register this scheduler as waiting for work. Returns false if there is already work in the shared queue.
+    bool EnterIdle()
+    {
+        std::lock_guard<std::mutex> lock{shared_queue_.mutex};
+        if (!shared_queue_.contexts.Empty()) {
+            return false;
+        }
+        shared_queue_.idle_schedulers.push_back(this);
+        return true;
+    }
+
+    void LeaveIdle()
+    {
+        std::lock_guard<std::mutex> lock{shared_queue_.mutex};
+        auto &idle_schedulers = shared_queue_.idle_schedulers;
+        idle_schedulers.erase(std::remove(idle_schedulers.begin(), idle_schedulers.end(), this), idle_schedulers.end());
+    }
+
+  private:
+    boost::fibers::context *pop_local()
+    {
+        auto ctx = &local_queue_.front();
+        local_queue_.pop_front();
+        return ctx;
+    }
+
+    void WaitForNotification(std::chrono::steady_clock::time_point time_point)
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        if (time_point == std::chrono::steady_clock::time_point::max()) {
+            condition_.wait(lock, [this] { return notified_; });
+        } else {
+            condition_.wait_until(lock, time_point, [this] { return notified_; });
+        }
+        notified_ = false;
+    }
+
+    SharedReadyQueue &shared_queue_;
+    boost::fibers::scheduler::ready_queue_type local_queue_;
+    bool prefer_local_ = false;
+
+    // Wake-ups of the thread, in the io_context or on the condition variable
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool notified_ = false;
+    bool in_io_context_ = false;
+    boost::asio::io_context &io_context_;
+    boost::asio::steady_timer wake_up_timer_;
+
+    // Hand-over between the dispatcher and the main fiber
+    boost::fibers::mutex park_mutex_;
+    boost::fibers::condition_variable park_condition_;
+    bool parked_ = false;
+    bool retired_ = false;
+    std::chrono::steady_clock::time_point sleep_until_ = std::chrono::steady_clock::time_point::max();
+};
+
+// Tasks of up to 64 bytes, e.g. the events and asynchronous calls with a few small arguments, are queued without
+// allocating
+using Task = InplaceFunction<void(), 64>;
+
+// Pool of long-lived fibers executing the tasks of an EventLoop one after the other, highest priority first.
+// A new fiber is only spawned when tasks are pending and none of the pooled fibers can take them, because they are
+// all suspended in a task, or busy while a worker thread of the EventLoop is sleeping.
+class FiberPool {
+  public:
+    FiberPool(SharedReadyQueue &shared_queue,
+              StackCache &stack_cache,
+              StackProfiler *profiler,
+              QueueLatencyRecorder *latency_recorder)
+        : shared_queue_(shared_queue),
+          stack_cache_(stack_cache),
+          profiler_(profiler),
+          latency_recorder_(latency_recorder),
+          tasks_(shared_queue.contexts.GetStarvationLimit())
+    {
+    }
+
+    FiberPool(const FiberPool &) = delete;
+    FiberPool(FiberPool &&) = delete;
+    FiberPool &operator=(const FiberPool &) = delete;
+    FiberPool &operator=(FiberPool &&) = delete;
+
+    // Called from the worker threads of the event loop, an idle worker is woken up to take the task
+    template <typename T>
+    void Push(Priority priority, std::chrono::steady_clock::time_point queued_at, T &&task)
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        tasks_.Push(priority, QueuedTask{Task{std::forward<T>(task)}, queued_at, priority});
+        WakeIdleWorker(lock);
+    }
+
+    // Can be called from any thread, as it does not touch the fiber primitives of the event loop. The task is taken by
+    // a busy worker, or by an idle one once the event loop calls WakeIdleWorker or SpawnIfStarved.
+    template <typename T>
+    void Enqueue(Priority priority, std::chrono::steady_clock::time_point queued_at, T &&task)
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        tasks_.Push(priority, QueuedTask{Task{std::forward<T>(task)}, queued_at, priority});
+    }
+
+    void WakeIdleWorker()
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        WakeIdleWorker(lock);
+    }
+
+    // Called by the event loop when it has nothing else to run, all the workers are then either idle, suspended or
+    // running on other threads. Returns true if a worker was woken up or spawned.
+    bool SpawnIfStarved()
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            if (tasks_.Empty() || wake_ups_ > 0 || stopped_) {
+                return false;
+            }
+            if (WakeIdleWorker(lock)) {
+                return true;
+            }
+        }
+        Spawn();
+        return true;
+    }
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stopped_ = true;
+        }
+        condition_.notify_all();
+    }
+
+  private:
+    static constexpr std::size_t kMaxIdleWorkers = 16;
+
+    // Unlocks the lock if a worker is woken up
+    bool WakeIdleWorker(std::unique_lock<std::mutex> &lock)
+    {
+        if (tasks_.Empty() || idle_workers_ == 0) {
+            return false;
+        }
+        --idle_workers_;
+        ++wake_ups_;
+        lock.unlock();
+        condition_.notify_one();
+        return true;
+    }
+
+    void Spawn()
+    {
+        if (!profiler_) {
+            boost::fibers::fiber(boost::fibers::launch::post, std::allocator_arg, CustomStackAllocator{stack_cache_},
+                                 [this] { Work(nullptr); })
+                .detach();
+            return;
+        }
+        auto signature = std::make_shared<const char *>(nullptr);
+        CustomStackAllocator allocator{stack_cache_, profiler_, signature};
+        boost::fibers::fiber(boost::fibers::launch::post, std::allocator_arg, allocator,
+                             [this, signature] { Work(signature.get()); })
+            .detach();
+    }
+
+    // When profiling, the fiber exits after a single task, reporting its signature to be measured with the stack
+    void Work(const char **signature)
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        for (;;) {
+            if (tasks_.Empty()) {
+                if (stopped_ || idle_workers_ >= kMaxIdleWorkers) {
+                    return;
+                }
+                ++idle_workers_;
+                condition_.wait(lock, [this] { return wake_ups_ > 0 || stopped_; });
+                if (wake_ups_ > 0) {
+                    --wake_ups_;
+                } else {
+                    --idle_workers_;
+                }
+                continue;
+            }
+
+            auto queued_task = tasks_.Pop();
+            // Let a sleeping worker thread take the remaining tasks while this one is busy
+            bool spawn_helper = !tasks_.Empty() && wake_ups_ == 0 && HasSleepingThreads();
+            lock.unlock();
+            if (spawn_helper) {
+                Spawn();
+            }
+            if (latency_recorder_) {
+                latency_recorder_->Record(queued_task.priority, queued_task.queued_at);
+            }
+            SetFiberPriority(queued_task.priority);
+            queued_task.task();
+            if (signature) {
+                auto completed_task = std::exchange(LastCompletedTask(), CompletedTask{});
+                if (completed_task.fiber == boost::fibers::context::active()) {
+                    *signature = completed_task.signature;
+                }
+                // The remaining tasks are taken by an idle worker, or by a new one on a freshly painted stack
+                lock.lock();
+                if (!WakeIdleWorker(lock)) {
+                    bool spawn = !tasks_.Empty();
+                    lock.unlock();
+                    if (spawn) {
+                        Spawn();
+                    }
+                }
+                return;
+            }
+            if (shared_queue_.pending_posts.load(std::memory_order_relaxed) > 0) {
+                boost::this_fiber::yield();
+            }
+            lock.lock();
+        }
+    }
+
+    bool HasSleepingThreads()
+    {
+        std::lock_guard<std::mutex> lock{shared_queue_.mutex};
+        return !shared_queue_.idle_schedulers.empty();
+    }
+
+    struct QueuedTask {
+        Task task;
+        std::chrono::steady_clock::time_point queued_at;
+        Priority priority;
+    };
+
+    SharedReadyQueue &shared_queue_;
+    StackCache &stack_cache_;
+    StackProfiler *profiler_;
+    QueueLatencyRecorder *latency_recorder_;
+    std::mutex mutex_;
+    boost::fibers::condition_variable_any condition_;
+    // Uses the starvation limit of the ready queue
+    PriorityLanes<QueuedTask> tasks_;
+    std::size_t idle_workers_ = 0;
+    std::size_t wake_ups_ = 0;
+    bool stopped_ = false;
+};
+
+// Fiber pools of an EventLoop, one per stack size. The pool using the stack size of the network is created up front,
+// the ones for signatures overriding the stack size when they are first used.
+// Only the stacks of the network size are cached in per-thread magazines, the other sizes share their depot.
+class FiberPools {
+  public:
+    FiberPools(SharedReadyQueue &shared_queue,
+               std::size_t stack_size,
+               std::size_t stack_cache_low_watermark,
+               std::size_t stack_cache_high_watermark,
+               std::size_t stack_arena_size,
+               StackProfiler *profiler,
+               QueueLatencyRecorder *latency_recorder)
+        : shared_queue_(shared_queue),
+          stack_cache_high_watermark_(stack_cache_high_watermark),
+          profiler_(profiler),
+          latency_recorder_(latency_recorder),
+          default_pool_(shared_queue,
+                        profiler,
+                        latency_recorder,
+                        stack_size,
+                        stack_cache_low_watermark,
+                        stack_cache_high_watermark,
+                        stack_arena_size)
+    {
+    }
+
+    FiberPools(const FiberPools &) = delete;
+    FiberPools(FiberPools &&) = delete;
+    FiberPools &operator=(const FiberPools &) = delete;
+    FiberPools &operator=(FiberPools &&) = delete;
+
+    // A stack size of 0 selects the pool of the network
+    FiberPool &Get(std::size_t stack_size)
+    {
+        if (stack_size == 0) {
+            return default_pool_.fiber_pool;
+        }
+        stack_size = StackCache::UsableStackSize(stack_size);
+        if (stack_size == default_pool_.stack_cache.GetStackSize()) {
+            return default_pool_.fiber_pool;
+        }
+
+        std::lock_guard<std::mutex> lock{mutex_};
+        auto &pool = pools_[stack_size];
+        if (!pool) {
+            pool = std::make_unique<Pool>(shared_queue_, profiler_, latency_recorder_, stack_size, 0,
+                                          stack_cache_high_watermark_);
+            if (stopped_) {
+                pool->fiber_pool.Stop();
+            }
+        }
+        return pool->fiber_pool;
+    }
+
+    StackCache &GetDefaultStackCache()
+    {
+        return default_pool_.stack_cache;
+    }
+
+    // Tasks running inline are measured by the event loop, the other ones by their fiber pool
+    void RecordQueueLatency(Priority priority, std::chrono::steady_clock::time_point queued_at)
+    {
+        if (latency_recorder_) {
+            latency_recorder_->Record(priority, queued_at);
+        }
+    }
+
+    void WakeIdleWorkers()
+    {
+        default_pool_.fiber_pool.WakeIdleWorker();
+        std::lock_guard<std::mutex> lock{mutex_};
+        for (auto &pool : pools_) {
+            pool.second->fiber_pool.WakeIdleWorker();
+        }
+    }
+
+    bool SpawnIfStarved()
+    {
+        if (default_pool_.fiber_pool.SpawnIfStarved()) {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock{mutex_};
+        for (auto &pool : pools_) {
+            if (pool.second->fiber_pool.SpawnIfStarved()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Stop()
+    {
+        default_pool_.fiber_pool.Stop();
+        std::lock_guard<std::mutex> lock{mutex_};
+        stopped_ = true;
+        for (auto &pool : pools_) {
+            pool.second->fiber_pool.Stop();
+        }
+    }
+
+    StackCacheStats GetStackCacheStats()
+    {
+        auto stats = default_pool_.stack_cache.GetStats();
+        std::lock_guard<std::mutex> lock{mutex_};
+        for (auto &pool : pools_) {
+            auto pool_stats = pool.second->stack_cache.GetStats();
+            stats.hits += pool_stats.hits;
+            stats.misses += pool_stats.misses;
+            stats.blocks_held += pool_stats.blocks_held;
+            stats.bytes_held += pool_stats.bytes_held;
+            stats.arena_bytes += pool_stats.arena_bytes;
+        }
+        return stats;
+    }
+
+  private:
+    struct Pool {
+        Pool(SharedReadyQueue &shared_queue,
+             StackProfiler *profiler,
+             QueueLatencyRecorder *latency_recorder,
+             std::size_t stack_size,
+             std::size_t stack_cache_low_watermark,
+             std::size_t stack_cache_high_watermark,
+             std::size_t stack_arena_size = 0)
+            : stack_cache(stack_size, stack_cache_low_watermark, stack_cache_high_watermark, stack_arena_size),
+              fiber_pool(shared_queue, stack_cache, profiler, latency_recorder)
+        {
+        }
+
+        StackCache stack_cache;
+        FiberPool fiber_pool;
+    };
+
+    SharedReadyQueue &shared_queue_;
+    const std::size_t stack_cache_high_watermark_;
+    StackProfiler *profiler_;
+    QueueLatencyRecorder *latency_recorder_;
+    Pool default_pool_;
+    std::mutex mutex_;
+    std::map<std::size_t, std::unique_ptr<Pool>> pools_;
+    bool stopped_ = false;
+};
+
+template <Execution execution, std::size_t stack_size, Priority priority, typename T>
+void Execute(FiberPools &fiber_pools, std::chrono::steady_clock::time_point queued_at, T &&task)
+{
+    if constexpr (execution == Execution::Inline) {
+        fiber_pools.RecordQueueLatency(priority, queued_at);
+        // Checked by the publishers of events whose bounded queue blocks them, and in debug builds by the scheduler,
+        // which is invoked as soon as the task tries to suspend
+        struct InlineTaskScope {
+            InlineTaskScope()
+            {
+                RunningInlineTask() = true;
+            }
+            ~InlineTaskScope()
+            {
+                RunningInlineTask() = false;
+            }
+        } scope;
+        task();
+    } else {
+        fiber_pools.Get(stack_size).Push(priority, queued_at, std::forward<T>(task));
+    }
+}
+
+// Bounded multi-producer single-consumer queue of tasks, stored in place in slots allocated up front.
+// Pushing never locks nor allocates, which makes it usable from real-time threads. Draining executes the tasks, and
+// must only be done from a single thread at a time.
+template <std::size_t Capacity, std::size_t TaskSize>
+class IngressQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "The ingress queue capacity must be a power of two");
+
+  public:
+    IngressQueue()
+    {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    ~IngressQueue()
+    {
+        Drain(Capacity, nullptr);
+    }
+
+    IngressQueue(const IngressQueue &) = delete;
+    IngressQueue(IngressQueue &&) = delete;
+    IngressQueue &operator=(const IngressQueue &) = delete;
+    IngressQueue &operator=(IngressQueue &&) = delete;
+
+    template <typename T>
+    static constexpr bool Fits()
+    {
+        return sizeof(std::decay_t<T>) <= TaskSize && alignof(std::decay_t<T>) <= alignof(std::max_align_t);
+    }
+
+    // The task is only moved from when the push succeeds
+    template <Execution execution, std::size_t stack_size, Priority priority, typename T>
+    bool TryPush(std::chrono::steady_clock::time_point queued_at, T &&task)
+    {
+        using task_type = std::decay_t<T>;
+        static_assert(Fits<T>(), "The task does not fit in an ingress queue slot, increase ingress_task_size");
+
+        auto position = enqueue_position_.load(std::memory_order_relaxed);
+        for (;;) {
+            auto &slot = slots_[position & (Capacity - 1)];
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0) {
+                if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    new (slot.storage) task_type(std::forward<T>(task));
+                    slot.queued_at = queued_at;
+                    slot.consume = &Consume<execution, stack_size, priority, task_type>;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueue_position_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Execute up to max_tasks queued tasks, or only destroy them if fiber_pools is null. Returns the number of tasks
+    // consumed
+    std::size_t Drain(std::size_t max_tasks, FiberPools *fiber_pools)
+    {
+        std::size_t consumed = 0;
+        while (consumed < max_tasks) {
+            auto &slot = slots_[dequeue_position_ & (Capacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != dequeue_position_ + 1) {
+                break;
+            }
+            slot.consume(slot.storage, slot.queued_at, fiber_pools);
+            slot.sequence.store(dequeue_position_ + Capacity, std::memory_order_release);
+            ++dequeue_position_;
+            ++consumed;
+        }
+        return consumed;
+    }
+
+    // Also true while a push is in progress, must be called from the draining thread
+    bool Empty() const
+    {
+        return enqueue_position_.load(std::memory_order_acquire) == dequeue_position_;
+    }
+
+  private:
+    template <Execution execution, std::size_t stack_size, Priority priority, typename T>
+    static void Consume(void *storage, std::chrono::steady_clock::time_point queued_at, FiberPools *fiber_pools)
+    {
+        auto task = static_cast<T *>(storage);
+        if (fiber_pools) {
+            Execute<execution, stack_size, priority>(*fiber_pools, queued_at, std::move(*task));
+        }
+        task->~T();
+    }
+
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        std::chrono::steady_clock::time_point queued_at;
+        void (*consume)(void *, std::chrono::steady_clock::time_point, FiberPools *);
+        alignas(std::max_align_t) unsigned char storage[TaskSize];
+    };
+
+    Slot slots_[Capacity];
+    alignas(64) std::atomic<std::size_t> enqueue_position_{0};
+    alignas(64) std::size_t dequeue_position_ = 0;
+};
+
+// Ingress queues of an EventLoop, one per priority, only present when the network declares an ingress_queue_capacity.
+// Producers wake the io_context up through an eventfd, which is neither locking nor allocating. The queues are drained
+// highest priority first.
+// Tasks must fit in the slots of the queues. Tasks pushed while a queue is full are kept in order in an overflow list
+// behind it, which locks and allocates: only TryPush is real-time safe. Tasks are only pushed to the queue again once
+// the overflow list is drained, so that they never overtake it.
+template <typename Network, bool Enabled = has_ingress_queue_capacity<Network>::value>
+class Ingress {
+  public:
+    Ingress(boost::asio::io_context &, FiberPools &, std::atomic<std::size_t> &)
+    {
+    }
+
+    template <Execution execution, std::size_t stack_size, Priority priority, typename T>
+    void Push(std::chrono::steady_clock::time_point, T &&)
+    {
+        static_assert(Enabled, "The network has no ingress queue, declare an ingress_queue_capacity in it");
+    }
+
+    template <Execution execution, std::size_t stack_size, Priority priority, typename T>
+    bool TryPush(std::chrono::steady_clock::time_point, T &&)
+    {
+        static_assert(Enabled, "The network has no ingress queue, declare an ingress_queue_capacity in it");
+        return false;
+    }
+};
+
+template <typename Network>
+class Ingress<Network, true> {
+  public:
+    // Every pushed task must have been counted in pending_posts
+    Ingress(boost::asio::io_context &io_context, FiberPools &fiber_pools, std::atomic<std::size_t> &pending_posts)
+        : fiber_pools_(fiber_pools),
+          pending_posts_(pending_posts),
+          descriptor_(io_context, ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    {
+        WaitForTasks();
+    }
+
+    // Never fails, the task being kept in the overflow list if the queue is full
+    template <Execution execution, std::size_t stack_size, Priority priority, typename T>
+    void Push(std::chrono::steady_clock::time_point queued_at, T &&task)
+    {
+        static_assert(fits_ingress_queue<Network, T>::value,
+                      "The task does not fit in an ingress queue slot, increase ingress_task_size");
+        // Only moved from when queued
+        if (TryPush<execution, stack_size, priority>(queued_at, std::forward<T>(task))) {
+            return;
+        }
+        auto &lane = lanes_[static_cast<std::size_t>(priority)];
+        {
+            std::lock_guard<std::mutex> lock{lane.mutex};
+            lane.overflow.emplace_back([queued_at, task = std::forward<T>(task)](FiberPools &fiber_pools) mutable {
+                Execute<execution, stack_size, priority>(fiber_pools, queued_at, std::move(task));
+            });
+            lane.overflowing.store(true, std::memory_order_relaxed);
+        }
+        WakeUp();
+    }
+
+    // Fails if the queue is full, or if tasks pushed before are waiting in the overflow list
+    template <Execution execution, std::size_t stack_size, Priority priority, typename T>
+    bool TryPush(std::chrono::steady_clock::time_point queued_at, T &&task)
+    {
+        static_assert(fits_ingress_queue<Network, T>::value,
+                      "The task does not fit in an ingress queue slot, increase ingress_task_size");
+        auto &lane = lanes_[static_cast<std::size_t>(priority)];
+        if (lane.overflowing.load(std::memory_order_acquire) ||
+            !lane.queue.template TryPush<execution, stack_size, priority>(queued_at, std::forward<T>(task))) {
+            return false;
+        }
+        WakeUp();
+        return true;
+    }
+
+  private:
+    void WakeUp()
+    {
+        if (!wake_up_pending_.exchange(true)) {
+            ::eventfd_write(descriptor_.native_handle(), 1);
+        }
+    }
+
+    void WaitForTasks()
+    {
+        descriptor_.async_read_some(boost::asio::buffer(&event_count_, sizeof(event_count_)),
+                                    [this](const boost::system::error_code &ec, std::size_t) {
+                                        if (ec) {
+                                            return;
+                                        }
+                                        wake_up_pending_ = false;
+                                        for (std::size_t i = kPriorityCount; i-- > 0;) {
+                                            Drain(lanes_[i]);
+                                        }
+                                        WaitForTasks();
+                                    });
+    }
+
+    static constexpr std::size_t task_size = ingress_task_size_or_default<Network>::value;
+    using queue_type = IngressQueue<Network::ingress_queue_capacity, task_size>;
+
+    struct Lane {
+        queue_type queue;
+        std::mutex mutex;
+        // Large enough for the task along with the time it was queued at, only the node of the list is allocated
+        std::deque<InplaceFunction<void(FiberPools &), task_size + alignof(std::max_align_t)>> overflow;
+        std::atomic<bool> overflowing{false};
+    };
+
+    void Drain(Lane &lane)
+    {
+        pending_posts_.fetch_sub(lane.queue.Drain(Network::ingress_queue_capacity, &fiber_pools_),
+                                 std::memory_order_relaxed);
+        // The overflow list is only drained behind all the tasks queued before it. A push still in progress wakes the
+        // io_context up again once it completes.
+        if (!lane.overflowing.load(std::memory_order_acquire) || !lane.queue.Empty()) {
+            return;
+        }
+        decltype(lane.overflow) overflow;
+        {
+            std::lock_guard<std::mutex> lock{lane.mutex};
+            overflow.swap(lane.overflow);
+            lane.overflowing.store(false, std::memory_order_release);
+        }
+        for (auto &task : overflow) {
+            task(fiber_pools_);
+        }
+        pending_posts_.fetch_sub(overflow.size(), std::memory_order_relaxed);
+    }
+
+    std::array<Lane, kPriorityCount> lanes_;
+    FiberPools &fiber_pools_;
+    std::atomic<std::size_t> &pending_posts_;
+    std::atomic<bool> wake_up_pending_{false};
+    eventfd_t event_count_ = 0;
+    boost::asio::posix::stream_descriptor descriptor_;
+};
+
+// Serves the Timers of a network, defined with the clock they use
+template <typename Network>
+class TimerWheel;
+
+template <typename Network>
+class EventLoop {
+  public:
+    EventLoop() : work_guard_{boost::asio::make_work_guard(io_context_)}
+    {
+        work_thread_ = std::thread{[this] { RunWorker(); }};
+    }
+    ~EventLoop()
+    {
+        Stop();
+    }
+
+    EventLoop(const EventLoop &) = delete;
+    EventLoop(EventLoop &&) = delete;
+    EventLoop &operator=(const EventLoop &) = delete;
+    EventLoop &operator=(EventLoop &&) = delete;
+
+    // Tasks are executed in their own fiber, unless they, or the network, are marked as non-suspending. A stack_size of
+    // 0 uses the stack size of the network. Pending tasks of a higher priority are started first, inline tasks are run
+    // in the order they are posted.
+    template <Execution execution = Execution::Fiber,
+              std::size_t stack_size = 0,
+              Priority priority = Priority::Normal,
+              typename T>
+    void Post(T &&task)
+    {
+        constexpr auto mode = is_non_suspending<Network>::value ? Execution::Inline : execution;
+        auto queued_at = QueuedAt<Network>();
+        if constexpr (has_ingress_queue_capacity<Network>::value) {
+            shared_ready_queue_.pending_posts.fetch_add(1, std::memory_order_relaxed);
+            ingress_.template Push<mode, stack_size, priority>(queued_at, std::forward<T>(task));
+        } else if constexpr (mode == Execution::Fiber) {
+            // Queued by priority right away instead of behind the handlers of the io_context
+            fiber_pools_.Get(stack_size).Enqueue(priority, queued_at, std::forward<T>(task));
+            WakeUp();
+        } else {
+            shared_ready_queue_.pending_posts.fetch_add(1, std::memory_order_relaxed);
+            boost::asio::post(io_context_, [this, queued_at, task = std::forward<T>(task)]() mutable {
+                shared_ready_queue_.pending_posts.fetch_sub(1, std::memory_order_relaxed);
+                Execute<mode, stack_size, priority>(fiber_pools_, queued_at, std::move(task));
+            });
+        }
+    }
+
+    template <Execution execution = Execution::Fiber,
+              std::size_t stack_size = 0,
+              Priority priority = Priority::Normal,
+              typename T>
+    PostStatus TryPost(T &&task)
+    {
+        constexpr auto mode = is_non_suspending<Network>::value ? Execution::Inline : execution;
+        shared_ready_queue_.pending_posts.fetch_add(1, std::memory_order_relaxed);
+        if (ingress_.template TryPush<mode, stack_size, priority>(QueuedAt<Network>(), std::forward<T>(task))) {
+            return PostStatus::Posted;
+        }
+        shared_ready_queue_.pending_posts.fetch_sub(1, std::memory_order_relaxed);
+        return PostStatus::QueueFull;
+    }
+
+    // Grow the pool of worker threads to thread_count. The pool never shrinks until the loop is stopped.
+    void SetWorkerThreadsAmount(int thread_count)
+    {
+        std::lock_guard<std::mutex> lock{threads_mutex_};
+        if (!work_thread_.joinable()) {
+            return;
+        }
+        while (static_cast<int>(additional_work_threads_.size()) + 1 < thread_count) {
+            additional_work_threads_.emplace_back([this] { RunWorker(); });
+        }
+    }
+
+    std::size_t GetWorkerThreadsAmount()
+    {
+        std::lock_guard<std::mutex> lock{threads_mutex_};
+        return additional_work_threads_.size() + 1;
+    }
+
+    void Stop()
+    {
+        std::lock_guard<std::mutex> lock{threads_mutex_};
+        // The worker threads are stopped from the thread leading the loop, fiber primitives might not be usable anymore
+        // from the calling thread (e.g. when called during static destruction)
+        boost::asio::post(io_context_, [this] {
+            stopped_ = true;
+            fiber_pools_.Stop();
+            std::lock_guard<std::mutex> lock{shared_ready_queue_.mutex};
+            for (auto scheduler : shared_ready_queue_.schedulers) {
+                scheduler->notify();
+            }
+        });
+        work_guard_.reset();
+
+        if (work_thread_.joinable()) {
+            work_thread_.join();
+        }
+        for (auto &thread : additional_work_threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+        io_context_.stop();
+    }
+
+    boost::asio::io_context &GetIOContext()
+    {
+        return io_context_;
+    }
+
+    StackCacheStats GetStackCacheStats()
+    {
+        return fiber_pools_.GetStackCacheStats();
+    }
+
+    StackProfile GetStackProfile()
+    {
+        return stack_profiler_.GetProfile();
+    }
+
+    QueueLatencyStats GetQueueLatencyStats()
+    {
+        return latency_recorder_.GetStats();
+    }
+
+    void CountDroppedCall(CallError reason)
+    {
+        auto &counter = reason == CallError::Cancelled ? cancelled_calls_ : expired_calls_;
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    DroppedCallStats GetDroppedCallStats()
+    {
+        return DroppedCallStats{expired_calls_.load(std::memory_order_relaxed),
+                                cancelled_calls_.load(std::memory_order_relaxed)};
+    }
+
+    TimerWheel<Network> &GetTimerWheel()
+    {
+        return timer_wheel_;
+    }
+
+  private:
+    // Let an idle fiber take the enqueued tasks. Wake-ups are coalesced, a pending one covers the tasks enqueued
+    // before it runs.
+    void WakeUp()
+    {
+        if (!wake_up_pending_.load(std::memory_order_relaxed) && !wake_up_pending_.exchange(true)) {
+            boost::asio::post(io_context_, [this] {
+                wake_up_pending_ = false;
+                fiber_pools_.WakeIdleWorkers();
+            });
+        }
+    }
+
+    // Every worker thread runs the fibers of the loop, and the handlers of the io_context while it leads
+    void RunWorker()
+    {
+        fiber_pools_.GetDefaultStackCache().AttachThread();
+        auto scheduler = new SharedWorkScheduler(shared_ready_queue_, io_context_);
+        boost::fibers::context::active()->get_scheduler()->set_algo(scheduler);
+        while (!stopped_) {
+            if (scheduler->Lead()) {
+                io_context_.poll();
+            }
+            if (scheduler->has_ready_fibers()) {
+                scheduler->StepDown();
+                boost::this_fiber::yield();
+                continue;
+            }
+            if (fiber_pools_.SpawnIfStarved()) {
+                continue;
+            }
+            scheduler->WaitForDispatcher();
+            scheduler->Sleep();
+        }
+        // Let the pooled fibers woken up by the stop terminate, they would otherwise be leaked with their stacks
+        while (scheduler->has_ready_fibers()) {
+            boost::this_fiber::yield();
+        }
+        scheduler->Retire();
+        fiber_pools_.GetDefaultStackCache().DetachThread();
+    }
+
+    boost::asio::io_context io_context_;
+    boost::asio::executor_work_guard<decltype(io_context_.get_executor())> work_guard_;
+    SharedReadyQueue shared_ready_queue_{priority_starvation_limit_or_default<Network>::value};
+    // Must outlive the worker threads, whose fiber schedulers release the stacks of the remaining fibers on exit
+    StackProfiler stack_profiler_;
+    QueueLatencyRecorder latency_recorder_;
+    std::atomic<std::size_t> expired_calls_{0};
+    std::atomic<std::size_t> cancelled_calls_{0};
+    TimerWheel<Network> timer_wheel_{io_context_};
+    FiberPools fiber_pools_{shared_ready_queue_,
+                            stack_size_or_default<Network, 30000>::value,
+                            stack_cache_low_watermark_or_default<Network>::value,
+                            stack_cache_high_watermark_or_default<Network>::value,
+                            stack_arena_size_or_default<Network>::value,
+                            profiles_stack_usage<Network>::value ? &stack_profiler_ : nullptr,
+                            measures_queue_latency<Network>::value ? &latency_recorder_ : nullptr};
+    Ingress<Network> ingress_{io_context_, fiber_pools_, shared_ready_queue_.pending_posts};
+    std::mutex threads_mutex_;
+    std::thread work_thread_;
+    std::vector<std::thread> additional_work_threads_;
+    std::atomic<bool> stopped_{false};
+    std::atomic<bool> wake_up_pending_{false};
+};
+
+template <typename Network = Default>
+EventLoop<Network> &getEventLoop()
+{
+    static EventLoop<Network> event_loop;
+    return event_loop;
+}
+
+// Tag the task with its signature, so that its stack usage is also aggregated per signature when the network profiles
+// the stack usage of its fibers
+template <typename Signature, typename Network, typename T>
+auto WithStackProfiling(T &&task)
+{
+    if constexpr (profiles_stack_usage<Network>::value) {
+        return [task = std::forward<T>(task)]() mutable {
+            task();
+            LastCompletedTask() = CompletedTask{boost::fibers::context::active(), typeid(Signature).name()};
+        };
+    } else {
+        return std::forward<T>(task);
+    }
+}
+
+// Fulfills the promise with what the callable returns, or with the exception it throws
+template <typename T, typename Callable>
+void FulfillPromise(boost::fibers::promise<T> &promise, Callable &&callable)
+{
+    try {
+        if constexpr (std::is_void<T>::value) {
+            callable();
+            promise.set_value();
+        } else {
+            promise.set_value(callable());
+        }
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+}
+
+// Shared by the task fulfilling the promise of a Future and the Future itself, so that a continuation can be attached
+// to the Future without a fiber waiting for it
+class ContinuationSlot {
+  public:
+    // The continuation is run right away, by the calling thread, if the promise is already fulfilled
+    void Attach(Task &&continuation)
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (!ready_) {
+                continuation_ = std::move(continuation);
+                return;
+            }
+        }
+        continuation();
+    }
+
+    // Called once the promise is fulfilled, by the thread which fulfilled it
+    void Ready()
+    {
+        Task continuation;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            ready_ = true;
+            continuation = std::move(continuation_);
+        }
+        if (continuation) {
+            continuation();
+        }
+    }
+
+  private:
+    std::mutex mutex_;
+    bool ready_ = false;
+    Task continuation_;
+};
+
+}  // namespace internal
+
+template <typename T>
+class Future;
+
+namespace internal {
+
+template <typename T>
+struct is_future : std::false_type {};
+
+template <typename T>
+struct is_future<Future<T>> : std::true_type {};
+
+// What a continuation returns, a Future returned by the continuation being unwrapped
+template <typename Callable, typename T>
+struct ContinuationResult {
+    using type = std::invoke_result_t<Callable, T>;
+};
+
+template <typename Callable>
+struct ContinuationResult<Callable, void> {
+    using type = std::invoke_result_t<Callable>;
+};
+
+template <typename T>
+struct UnwrappedFuture {
+    using type = T;
+};
+
+template <typename T>
+struct UnwrappedFuture<Future<T>> {
+    using type = T;
+};
+
+// Value type of a combined future: void becomes std::nullptr_t and references are wrapped
+template <typename T>
+using combined_t = std::conditional_t<
+    std::is_void<T>::value,
+    std::nullptr_t,
+    std::conditional_t<std::is_reference<T>::value, std::reference_wrapper<std::remove_reference_t<T>>, T>>;
+
+// Runs the callable with the ready boost::fibers::future of the Future, inline, by the thread fulfilling it
+template <typename T, typename Callable>
+void OnReady(Future<T> &&future, Callable &&callable);
+
+template <typename T>
+combined_t<T> GetCombined(boost::fibers::future<T> &future)
+{
+    if constexpr (std::is_void<T>::value) {
+        future.get();
+        return nullptr;
+    } else {
+        return future.get();
+    }
+}
+
+template <typename T, typename Callable>
+decltype(auto) InvokeWithResult(boost::fibers::future<T> &previous, Callable &callable)
+{
+    if constexpr (std::is_void<T>::value) {
+        previous.get();
+        return callable();
+    } else {
+        return callable(previous.get());
+    }
+}
+
+// Fulfills the promise of a continuation with what the callable returns from the previous result. An exception held
+// by the previous future skips the callable and is forwarded.
+template <typename T, typename R, typename Callable>
+void RunContinuation(boost::fibers::future<T> &previous,
+                     boost::fibers::promise<R> &promise,
+                     std::shared_ptr<ContinuationSlot> slot,
+                     Callable &callable)
+{
+    using result_t = typename ContinuationResult<Callable, T>::type;
+    if constexpr (is_future<result_t>::value) {
+        try {
+            OnReady(InvokeWithResult(previous, callable),
+                    [promise = std::move(promise), slot](boost::fibers::future<R> &inner) mutable {
+                        FulfillPromise(promise, [&]() -> R { return inner.get(); });
+                        slot->Ready();
+                    });
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+            slot->Ready();
+        }
+    } else {
+        FulfillPromise(promise, [&]() -> R { return InvokeWithResult(previous, callable); });
+        slot->Ready();
+    }
+}
+
+}  // namespace internal
+
+/**
+ * @brief Future of an asynchronous call, which can be chained with continuations instead of being waited for.
+ *
+ * It is a `boost::fibers::future`, and can be waited for or converted to one as such.
+ *
+ * @tparam T The type of the result.
+ */
+template <typename T>
+class Future : public boost::fibers::future<T> {
+  public:
+    Future() = default;
+    Future(boost::fibers::future<T> &&future, std::shared_ptr<internal::ContinuationSlot> slot)
+        : boost::fibers::future<T>(std::move(future)), slot_(std::move(slot))
+    {
+    }
+
+    /**
+     * @brief Run a callable with the result once it is available, without any fiber waiting for it.
+     *
+     * The callable is posted to the event loop of the network once the result is available, and receives it as its
+     * argument, or no argument if T is void. If the future holds an exception, the callable is skipped and the
+     * exception is forwarded to the returned future. A callable returning a Future, e.g. from `async_call`, is
+     * unwrapped, so that the steps of a flow can be chained. This future is no longer valid afterwards.
+     *
+     * @tparam Network The network whose event loop runs the callable (default is `internal::Default`).
+     * @param callable The continuation.
+     * @return A Future holding what the callable returns, or the exception it throws.
+     * @throws boost::fibers::future_uninitialized If this future is not valid.
+     *
+     * Example
+     * @code
+     * dispatcher::async_call<Addition>(1, 2)
+     *     .then([](int sum) { return dispatcher::async_call<Multiplication>(sum, 10); })
+     *     .then([](int product) { std::cout << product << std::endl; });  // 30
+     * @endcode
+     */
+    template <typename Network = internal::Default, typename Callable>
+    auto then(Callable &&callable)
+    {
+        using result_t = typename internal::ContinuationResult<std::decay_t<Callable>, T>::type;
+        using value_t = typename internal::UnwrappedFuture<result_t>::type;
+        boost::fibers::promise<value_t> promise;
+        auto slot = std::make_shared<internal::ContinuationSlot>();
+        Future<value_t> next{promise.get_future(), slot};
+        internal::OnReady(std::move(*this),
+                          [promise = std::move(promise), slot = std::move(slot),
+                           callable = std::forward<Callable>(callable)](boost::fibers::future<T> &previous) mutable {
+                              internal::getEventLoop<Network>().Post(
+                                  [previous = std::move(previous), promise = std::move(promise),
+                                   slot = std::move(slot), callable = std::move(callable)]() mutable {
+                                      internal::RunContinuation(previous, promise, std::move(slot), callable);
+                                  });
+                          });
+        return next;
+    }
+
+  private:
+    template <typename U, typename Callable>
+    friend void internal::OnReady(Future<U> &&future, Callable &&callable);
+
+    std::shared_ptr<internal::ContinuationSlot> slot_;
+};
+
+namespace internal {
+
+template <typename T, typename Callable>
+void OnReady(Future<T> &&future, Callable &&callable)
+{
+    if (!future.slot_) {
+        throw boost::fibers::future_uninitialized{};
+    }
+    auto slot = std::move(future.slot_);
+    slot->Attach([future = boost::fibers::future<T>{std::move(future)},
+                  callable = std::forward<Callable>(callable)]() mutable { callable(future); });
+}
+
+// Results of the futures combined by when_all, stored as they complete. The last one to complete fulfills the promise
+// with all of them, or with the first exception.
+template <typename Results>
+class WhenAllState {
+  public:
+    // Without futures to combine, Complete must be called once
+    explicit WhenAllState(Results results, std::size_t count)
+        : results_(std::move(results)), remaining_(std::max<std::size_t>(count, 1))
+    {
+    }
+
+    Future<typename Results::value_type> GetFuture()
+    {
+        return Future<value_t>{promise_.get_future(), slot_};
+    }
+
+    template <typename Store>
+    void Complete(Store &&store)
+    {
+        try {
+            store(results_);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (!exception_) {
+                exception_ = std::current_exception();
+            }
+        }
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            if (exception_) {
+                promise_.set_exception(exception_);
+            } else {
+                FulfillPromise(promise_, [this] { return results_.Get(); });
+            }
+            slot_->Ready();
+        }
+    }
+
+  private:
+    using value_t = typename Results::value_type;
+
+    Results results_;
+    std::atomic<std::size_t> remaining_;
+    std::mutex mutex_;
+    std::exception_ptr exception_;
+    boost::fibers::promise<value_t> promise_;
+    std::shared_ptr<ContinuationSlot> slot_ = std::make_shared<ContinuationSlot>();
+};
+
+template <typename... T>
+struct TupleResults {
+    using value_type = std::tuple<combined_t<T>...>;
+
+    value_type Get()
+    {
+        return std::apply([](auto &...results) { return value_type{std::move(*results)...}; }, results);
+    }
+
+    std::tuple<std::optional<combined_t<T>>...> results;
+};
+
+template <typename T>
+struct VectorResults {
+    using value_type = std::vector<combined_t<T>>;
+
+    value_type Get()
+    {
+        value_type values;
+        values.reserve(results.size());
+        for (auto &result : results) {
+            values.push_back(std::move(*result));
+        }
+        return values;
+    }
+
+    std::vector<std::optional<combined_t<T>>> results;
+};
+
+// Posts the invocation of the handler of the function signature to the event loop of the network. Invoke receives the
+// arguments, and its outcome, value or exception, fulfills the returned future
+template <typename FuncSignature, typename Network, typename T, typename Invoke, typename... Args>
+Future<T> PostCall(Invoke invoke, Args &&...args)
+{
+    boost::fibers::promise<T> promise;
+    auto slot = std::make_shared<ContinuationSlot>();
+    Future<T> future{promise.get_future(), slot};
+
+    auto argsTuple = std::make_tuple(std::forward<Args>(args)...);
+    constexpr auto execution = is_non_suspending<FuncSignature>::value ? Execution::Inline : Execution::Fiber;
+    constexpr auto stack_size = stack_size_or_default<FuncSignature>::value;
+    getEventLoop<Network>().template Post<execution, stack_size, priority_or_default<FuncSignature>::value>(
+        WithStackProfiling<FuncSignature, Network>(
+            [promise = std::move(promise), slot = std::move(slot), argsTuple = std::move(argsTuple), invoke]() mutable {
+                FulfillPromise(promise, [&]() -> T { return std::apply(invoke, std::move(argsTuple)); });
+                slot->Ready();
+            }));
+    return future;
+}
+
+// Same as PostCall, the call being dropped when it is about to run if the options tell so. Drop then fulfills the
+// promise from the CallError, without throwing so that a backlog of dropped calls is cheap to drain.
+template <typename FuncSignature, typename Network, typename T, typename Invoke, typename Drop, typename... Args>
+Future<T> PostCall(CallOptions options, Invoke invoke, Drop drop, Args &&...args)
+{
+    boost::fibers::promise<T> promise;
+    auto slot = std::make_shared<ContinuationSlot>();
+    Future<T> future{promise.get_future(), slot};
+
+    auto argsTuple = std::make_tuple(std::forward<Args>(args)...);
+    constexpr auto execution = is_non_suspending<FuncSignature>::value ? Execution::Inline : Execution::Fiber;
+    constexpr auto stack_size = stack_size_or_default<FuncSignature>::value;
+    getEventLoop<Network>().template Post<execution, stack_size, priority_or_default<FuncSignature>::value>(
+        WithStackProfiling<FuncSignature, Network>([options = std::move(options), promise = std::move(promise),
+                                                    slot = std::move(slot), argsTuple = std::move(argsTuple), invoke,
+                                                    drop]() mutable {
+            if (auto reason = options.Check()) {
+                getEventLoop<Network>().CountDroppedCall(*reason);
+                drop(promise, *reason);
+            } else {
+                FulfillPromise(promise, [&]() -> T { return std::apply(invoke, std::move(argsTuple)); });
+            }
+            slot->Ready();
+        }));
+    return future;
+}
+
+template <typename F, typename Tuple, std::size_t... Is>
+auto call_with_tuple(F &&f, Tuple &&t, std::index_sequence<Is...>)
+{
+    return f(std::get<Is>(std::forward<Tuple>(t))...);
+}
+
+template <typename F, typename Tuple>
+auto call_with_tuple(F &&f, Tuple &&t)
+{
+    constexpr auto size = std::tuple_size<std::decay_t<Tuple>>::value;
+    return call_with_tuple(std::forward<F>(f), std::forward<Tuple>(t), std::make_index_sequence<size>{});
+}
+
+template <typename EventSignature, typename Network, typename signal_type>
+signal_type &GetSignal()
+{
+    static signal_type signal;
+    return signal;
+}
+
+// Events of a signature declaring an event_queue_bound, directly or through its network. The event loop is handed one
+// token per queued event, which runs the oldest one, so that queued events can be dropped and counted.
+class BoundedEventQueue {
+  public:
+    enum class Admission {
+        Queued,    // A token must be posted for the event
+        Replaced,  // The event replaced the oldest one, and takes over its token
+        Dropped,
+        Rejected
+    };
+
+    BoundedEventQueue(std::size_t bound, OverflowPolicy policy) : bound_(bound), policy_(policy)
+    {
+    }
+
+    BoundedEventQueue(const BoundedEventQueue &) = delete;
+    BoundedEventQueue(BoundedEventQueue &&) = delete;
+    BoundedEventQueue &operator=(const BoundedEventQueue &) = delete;
+    BoundedEventQueue &operator=(BoundedEventQueue &&) = delete;
+
+    // The Block policy rejects the event instead when the publisher cannot be suspended
+    Admission Push(Task &&event, bool can_block)
+    {
+        Task evicted;
+        std::unique_lock<boost::fibers::mutex> lock{mutex_};
+        if (events_.size() >= bound_) {
+            switch (policy_) {
+            case OverflowPolicy::Block:
+                if (!can_block) {
+                    ++rejected_;
+                    return Admission::Rejected;
+                }
+                ++blocked_publishers_;
+                not_full_.wait(lock, [this] { return events_.size() < bound_; });
+                --blocked_publishers_;
+                break;
+            case OverflowPolicy::DropNewest:
+                ++dropped_;
+                return Admission::Dropped;
+            case OverflowPolicy::DropOldest:
+                evicted = std::move(events_.front());
+                events_.pop_front();
+                events_.push_back(std::move(event));
+                ++dropped_;
+                return Admission::Replaced;
+            case OverflowPolicy::Fail:
+                ++rejected_;
+                return Admission::Rejected;
+            }
+        }
+        events_.push_back(std::move(event));
+        high_water_depth_ = std::max(high_water_depth_, events_.size());
+        return Admission::Queued;
+    }
+
+    // Run by the tokens posted to the event loop
+    void RunOldest()
+    {
+        std::unique_lock<boost::fibers::mutex> lock{mutex_};
+        auto event = std::move(events_.front());
+        events_.pop_front();
+        // Blocked publishers are released once half of the queue is drained, so that they refill it in a burst
+        // instead of being woken up for every single event
+        bool notify = blocked_publishers_ > 0 && events_.size() <= bound_ / 2;
+        lock.unlock();
+        if (notify) {
+            not_full_.notify_all();
+        }
+        event();
+    }
+
+    EventQueueStats GetStats()
+    {
+        std::lock_guard<boost::fibers::mutex> lock{mutex_};
+        return EventQueueStats{events_.size(), high_water_depth_, dropped_, rejected_, blocked_publishers_};
+    }
+
+  private:
+    const std::size_t bound_;
+    const OverflowPolicy policy_;
+    boost::fibers::mutex mutex_;
+    boost::fibers::condition_variable not_full_;
+    std::deque<Task> events_;
+    std::size_t blocked_publishers_ = 0;
+    std::size_t high_water_depth_ = 0;
+    std::size_t dropped_ = 0;
+    std::size_t rejected_ = 0;
+};
+
+template <typename Tuple>
+struct is_trivially_copyable_tuple : std::false_type {};
+
+template <typename... Types>
+struct is_trivially_copyable_tuple<std::tuple<Types...>> : std::conjunction<std::is_trivially_copyable<Types>...> {};
+
+// Value guarded by a mutex, for the values which cannot be copied byte per byte
+template <typename Tuple>
+class LockedSlot {
+  public:
+    template <typename... Parameters>
+    void Write(Parameters &&...parameters)
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        value_.emplace(std::forward<Parameters>(parameters)...);
+        ++version_;
+    }
+
+    // Empty until written, version is increased by every write
+    std::optional<Tuple> Read(std::uint64_t &version) const
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        version = version_;
+        return value_;
+    }
+
+  private:
+    mutable std::mutex mutex_;
+    std::optional<Tuple> value_;
+    std::uint64_t version_ = 0;
+};
+
+// Value guarded by a sequence lock: the writers never wait for the readers, and the readers retry while a writer
+// overwrites the value. Its bytes are stored in words accessed atomically, so that a read racing with a write is
+// retried instead of undefined. The writers only wait for each other while they copy the value.
+template <typename Tuple>
+class SeqLockSlot;
+
+template <typename... Types>
+class SeqLockSlot<std::tuple<Types...>> {
+    using Tuple = std::tuple<Types...>;
+    static constexpr std::size_t size = (sizeof(Types) + ... + 0);
+    static constexpr std::size_t word_count = (size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+    using Bytes = std::array<unsigned char, word_count * sizeof(std::uint64_t)>;
+
+  public:
+    template <typename... Parameters>
+    void Write(Parameters &&...parameters)
+    {
+        auto bytes = Encode(Tuple(std::forward<Parameters>(parameters)...), std::index_sequence_for<Types...>{});
+        std::array<std::uint64_t, word_count> words;
+        std::memcpy(words.data(), bytes.data(), bytes.size());
+
+        auto sequence = sequence_.load(std::memory_order_relaxed);
+        for (;;) {
+            if (sequence % 2 != 0) {
+                std::this_thread::yield();
+                sequence = sequence_.load(std::memory_order_relaxed);
+            } else if (sequence_.compare_exchange_weak(sequence, sequence + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        // Orders the odd sequence before the words, see Read
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < word_count; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Empty until written, version is increased by every write
+    std::optional<Tuple> Read(std::uint64_t &version) const
+    {
+        std::array<std::uint64_t, word_count> words;
+        for (;;) {
+            version = sequence_.load(std::memory_order_acquire);
+            if (version % 2 != 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (std::size_t i = 0; i < word_count; ++i) {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            // Orders the words before reading the sequence again
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == version) {
+                break;
+            }
+        }
+        if (version == 0) {
+            return std::nullopt;
+        }
+        Bytes bytes;
+        std::memcpy(bytes.data(), words.data(), bytes.size());
+        return Decode(bytes, std::index_sequence_for<Types...>{});
+    }
+
+  private:
+    template <std::size_t... I>
+    static Bytes Encode(const Tuple &value, std::index_sequence<I...>)
+    {
+        Bytes bytes{};
+        std::size_t offset = 0;
+        ((std::memcpy(bytes.data() + offset, &std::get<I>(value), sizeof(Types)), offset += sizeof(Types)), ...);
+        return bytes;
+    }
+
+    template <std::size_t... I>
+    static Tuple Decode(const Bytes &bytes, std::index_sequence<I...>)
+    {
+        return Tuple{DecodeAt<Types>(bytes, Offset<I>())...};
+    }
+
+    template <typename T>
+    static T DecodeAt(const Bytes &bytes, std::size_t offset)
+    {
+        std::array<unsigned char, sizeof(T)> element;
+        std::memcpy(element.data(), bytes.data() + offset, sizeof(T));
+        return std::bit_cast<T>(element);
+    }
+
+    template <std::size_t I>
+    static constexpr std::size_t Offset()
+    {
+        constexpr std::array<std::size_t, sizeof...(Types) + 1> sizes{sizeof(Types)..., 0};
+        std::size_t offset = 0;
+        for (std::size_t i = 0; i < I; ++i) {
+            offset += sizes[i];
+        }
+        return offset;
+    }
+
+    // Odd while a writer copies the value, 0 until the first write
+    std::atomic<std::uint64_t> sequence_{0};
+    std::array<std::atomic<std::uint64_t>, word_count> words_{};
+};
+
+// Value of a conflating event signature. Publishing overwrites the value, and a single token is posted to the event
+// loop until it delivers the value, however many times it is overwritten in between: at most one value is pending.
+// Values whose parameters are all trivially copyable are published and read without lock.
+template <typename Tuple>
+class LatestValue {
+  public:
+    // Returns true if a token must be posted for the value
+    template <typename... Parameters>
+    bool Store(Parameters &&...parameters)
+    {
+        slot_.Write(std::forward<Parameters>(parameters)...);
+        // Releases the value to the token clearing the flag
+        if (pending_.exchange(true, std::memory_order_acq_rel)) {
+            overwritten_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        high_water_depth_.store(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // The token could not be posted, the next value posts a new one
+    void Unpost()
+    {
+        pending_.store(false, std::memory_order_release);
+    }
+
+    // Run by the token, the value stays readable once delivered. Empty if the value was already delivered, by a token
+    // racing with the value published after it cleared the flag.
+    std::optional<Tuple> Take()
+    {
+        pending_.exchange(false, std::memory_order_acq_rel);
+        std::uint64_t version;
+        auto value = slot_.Read(version);
+        auto delivered = delivered_.load(std::memory_order_relaxed);
+        do {
+            if (delivered >= version) {
+                return std::nullopt;
+            }
+        } while (!delivered_.compare_exchange_weak(delivered, version, std::memory_order_relaxed));
+        return value;
+    }
+
+    std::optional<Tuple> Get() const
+    {
+        std::uint64_t version;
+        return slot_.Read(version);
+    }
+
+    EventQueueStats GetStats() const
+    {
+        return EventQueueStats{pending_.load(std::memory_order_relaxed) ? 1u : 0u,
+                               high_water_depth_.load(std::memory_order_relaxed),
+                               overwritten_.load(std::memory_order_relaxed),
+                               0,
+                               0};
+    }
+
+  private:
+    using slot_type =
+        std::conditional_t<is_trivially_copyable_tuple<Tuple>::value, SeqLockSlot<Tuple>, LockedSlot<Tuple>>;
+
+    slot_type slot_;
+    std::atomic<bool> pending_{false};
+    std::atomic<std::uint64_t> delivered_{0};
+    std::atomic<std::size_t> high_water_depth_{0};
+    std::atomic<std::size_t> overwritten_{0};
+};
+
+template <typename EventSignature, typename Network = internal::Default>
+struct EventDispatcher {
+    template <typename Callable>
+    static Connection subscribe(Callable &&callable)
+    {
+        return GetSignal<EventSignature, Network, signal_type>().Connect(std::forward<Callable>(callable));
+    }
+
+    template <typename... Parameters>
+    static void publish(Parameters &&...parameters)
+    {
+        if constexpr (is_conflating_event) {
+            if (GetLatest().Store(std::forward<Parameters>(parameters)...)) {
+                getEventLoop<Network>().template Post<execution, stack_size, priority>(make_latest_task());
+            }
+        } else if constexpr (is_bounded) {
+            // Suspending the event loop thread outside of a fiber would keep it from ever draining the queue
+            bool can_block = !RunningInlineTask() &&
+                             !getEventLoop<Network>().GetIOContext().get_executor().running_in_this_thread();
+            auto admission = GetQueue().Push(make_task(std::forward<Parameters>(parameters)...), can_block);
+            if (admission == BoundedEventQueue::Admission::Queued) {
+                PostToken();
+            } else if (admission == BoundedEventQueue::Admission::Rejected) {
+                throw EventQueueFull<EventSignature>{};
+            }
+        } else {
+            getEventLoop<Network>().template Post<execution, stack_size, priority>(
+                make_task(std::forward<Parameters>(parameters)...));
+        }
+    }
+
+    template <typename... Parameters>
+    static PostStatus try_publish(Parameters &&...parameters)
+    {
+        if constexpr (is_conflating_event) {
+            if (!GetLatest().Store(std::forward<Parameters>(parameters)...)) {
+                return PostStatus::Posted;
+            }
+            auto status = getEventLoop<Network>().template TryPost<execution, stack_size, priority>(make_latest_task());
+            if (status != PostStatus::Posted) {
+                GetLatest().Unpost();
+            }
+            return status;
+        } else if constexpr (is_bounded) {
+            switch (GetQueue().Push(make_task(std::forward<Parameters>(parameters)...), false)) {
+            case BoundedEventQueue::Admission::Queued:
+                PostToken();
+                return PostStatus::Posted;
+            case BoundedEventQueue::Admission::Replaced:
+                return PostStatus::Posted;
+            default:
+                return PostStatus::QueueFull;
+            }
+        } else {
+            return getEventLoop<Network>().template TryPost<execution, stack_size, priority>(
+                make_task(std::forward<Parameters>(parameters)...));
+        }
+    }
+
+    static EventQueueStats get_queue_stats()
+    {
+        if constexpr (is_conflating_event) {
+            return GetLatest().GetStats();
+        } else if constexpr (is_bounded) {
+            return GetQueue().GetStats();
+        } else {
+            return {};
+        }
+    }
+
+    static BoundedEventQueue &GetQueue()
+    {
+        static BoundedEventQueue queue{queue_bound, overflow_policy};
+        return queue;
+    }
+
+    static void PostToken()
+    {
+        getEventLoop<Network>().template Post<execution, stack_size, priority>([] { GetQueue().RunOldest(); });
+    }
+
+    static auto &GetLatest()
+    {
+        static LatestValue<latest_t> latest;
+        return latest;
+    }
+
+    static auto get_latest()
+    {
+        static_assert(is_conflating_event, "Only conflating events keep their latest value");
+        std::optional<event_t> latest;
+        if (auto value = GetLatest().Get()) {
+            latest.emplace(std::make_from_tuple<event_t>(std::move(*value)));
+        }
+        return latest;
+    }
+
+    // Delivers the value published last when the token is run
+    static auto make_latest_task()
+    {
+        return WithStackProfiling<EventSignature, Network>([] {
+            if (auto parametersTuple = GetLatest().Take()) {
+                dispatch_unkeyed(*parametersTuple);
+            }
+        });
+    }
+
+    template <typename Callable>
+    static Connection subscribe_batch(Callable &&callable)
+    {
+        return GetSignal<EventSignature, Network, batch_signal_type>().Connect(std::forward<Callable>(callable));
+    }
+
+    template <typename Key, typename Callable>
+    static Connection subscribe(Key &&key, Callable &&callable)
+    {
+        static_assert(is_keyed, "Only events declaring a key_t can be subscribed to by key");
+        return GetSignal<EventSignature, Network, keyed_subscribers_type>()
+            .GetOrCreate(key_t(std::forward<Key>(key)))
+            .Connect(std::forward<Callable>(callable));
+    }
+
+    template <typename Range>
+    static void publish_batch(Range &&events)
+    {
+        static_assert(!is_keyed, "Keyed events cannot be published by batch");
+        static_assert(!is_conflating_event, "Conflating events cannot be published by batch");
+        getEventLoop<Network>().template Post<execution, stack_size, priority>(
+            WithStackProfiling<EventSignature, Network>([batch = batch_t{std::forward<Range>(events)}] {
+                batch.Dispatch(GetSignal<EventSignature, Network, batch_signal_type>(),
+                               GetSignal<EventSignature, Network, signal_type>());
+            }));
+    }
+
+    template <typename... Parameters>
+    static auto make_task(Parameters &&...parameters)
+    {
+        if constexpr (is_keyed) {
+            return make_keyed_task(std::forward<Parameters>(parameters)...);
+        } else {
+            return make_unkeyed_task(std::forward<Parameters>(parameters)...);
+        }
+    }
+
+    // The subscribers of the key are called after the ones subscribed to every key
+    template <typename Key, typename... Parameters>
+    static auto make_keyed_task(Key &&key, Parameters &&...parameters)
+    {
+        auto parametersTuple = std::make_tuple(std::forward<Parameters>(parameters)...);
+        return WithStackProfiling<EventSignature, Network>(
+            [key = key_t(std::forward<Key>(key)), parametersTuple = std::move(parametersTuple)]() mutable {
+                auto &batch_signal = GetSignal<EventSignature, Network, batch_signal_type>();
+                if (!batch_signal.Empty()) {
+                    batch_t::DispatchOne(batch_signal, parametersTuple);
+                }
+                auto &signal = GetSignal<EventSignature, Network, signal_type>();
+                auto keyed = GetSignal<EventSignature, Network, keyed_subscribers_type>().Find(key);
+                if (keyed == nullptr) {
+                    call_with_tuple(signal, std::move(parametersTuple));
+                    return;
+                }
+                call_with_tuple(signal, parametersTuple);
+                call_with_tuple(*keyed, std::move(parametersTuple));
+            });
+    }
+
+    template <typename... Parameters>
+    static auto make_unkeyed_task(Parameters &&...parameters)
+    {
+        auto parametersTuple = std::make_tuple(std::forward<Parameters>(parameters)...);
+        return WithStackProfiling<EventSignature, Network>(
+            [parametersTuple = std::move(parametersTuple)]() mutable { dispatch_unkeyed(parametersTuple); });
+    }
+
+    template <typename Tuple>
+    static void dispatch_unkeyed(Tuple &parametersTuple)
+    {
+        // Before the other subscribers, which may be handed the parameters by move
+        auto &batch_signal = GetSignal<EventSignature, Network, batch_signal_type>();
+        if (!batch_signal.Empty()) {
+            batch_t::DispatchOne(batch_signal, parametersTuple);
+        }
+        call_with_tuple(GetSignal<EventSignature, Network, signal_type>(), std::move(parametersTuple));
+    }
+
+    using parameters_t =
+        typename parameters_t_or_default<EventSignature, has_parameters_t<EventSignature>::value>::type;
+
+    using signal_type = typename SignalFromTuple<parameters_t>::type;
+
+    static_assert(!is_zero_copy<EventSignature>::value || !has_parameter_copied_per_subscriber<parameters_t>::value,
+                  "A parameter of this zero_copy event is copied for every subscriber, declare it as a const reference "
+                  "or as a dispatcher::Shared<T>");
+
+    static constexpr bool is_keyed = has_key_t<EventSignature>::value;
+    using key_t = typename key_t_or_default<EventSignature, is_keyed>::type;
+    using keyed_subscribers_type = KeyedSubscribers<key_t, signal_type>;
+
+    using batch_t = EventBatch<parameters_t, is_columnar_batch<EventSignature>::value>;
+    using batch_signal_type = typename batch_t::batch_signal_type;
+    using event_t = typename batch_t::event_t;
+
+    static constexpr bool is_conflating_event = is_conflating<EventSignature>::value;
+    using latest_t = typename DecayedTuple<parameters_t>::type;
+    static_assert(!is_conflating_event || !is_keyed, "Keyed events cannot be conflating");
+
+    static constexpr Execution execution =
+        is_non_suspending<EventSignature>::value ? Execution::Inline : Execution::Fiber;
+    static constexpr std::size_t stack_size = stack_size_or_default<EventSignature>::value;
+    static constexpr Priority priority = priority_or_default<EventSignature>::value;
+
+    static constexpr std::size_t queue_bound =
+        event_queue_bound_or_default<EventSignature, event_queue_bound_or_default<Network>::value>::value;
+    static constexpr OverflowPolicy overflow_policy =
+        overflow_policy_or_default<EventSignature, overflow_policy_or_default<Network>::value>::value;
+    static constexpr bool is_bounded = queue_bound > 0;
+};
+
+inline boost::optional<boost::asio::deadline_timer::traits_type::time_type> &Now()
+{
+    static boost::optional<boost::asio::deadline_timer::traits_type::time_type> now;
+    return now;
+}
+
+// This clock can be settable in unit test
+struct MockableClock {
+    typedef boost::asio::deadline_timer::traits_type source_traits;
+
+  public:
+    typedef source_traits::time_type time_type;
+    typedef source_traits::duration_type duration_type;
+
+    static time_type now()
+    {
+        if (Now()) {
+            return *Now();
+        }
+
+        return chrono_to_ptime(std::chrono::system_clock::now());
+    }
+
+    // To be used in testing only
+
+    static void set_now(time_type t = chrono_to_ptime(std::chrono::system_clock::now()))
+    {
+        Now() = t;
+    }
+
+    template <typename Duration>
+    static void advance_time(Duration &&d)
+    {
+        if (!Now()) {
+            return;
+        }
+        *Now() = add(*Now(),
+                     boost::posix_time::milliseconds(std::chrono::duration_cast<std::chrono::milliseconds>(d).count()));
+        std::this_thread::sleep_for(std::chrono::microseconds(1100));
+    }
+
+    static time_type add(time_type t, duration_type d)
+    {
+        return source_traits::add(t, d);
+    }
+    static duration_type subtract(time_type t1, time_type t2)
+    {
+        return source_traits::subtract(t1, t2);
+    }
+    static bool less_than(time_type t1, time_type t2)
+    {
+        return source_traits::less_than(t1, t2);
+    }
+
+    static boost::posix_time::time_duration to_posix_duration(duration_type d)
+    {
+        if (!Now()) {
+            return d;
+        }
+        return d < boost::posix_time::milliseconds(1) ? d : boost::posix_time::milliseconds(1);
+    }
+
+    static boost::posix_time::ptime chrono_to_ptime(const std::chrono::system_clock::time_point &tp)
+    {
+        auto duration = tp.time_since_epoch();
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(duration);
+        auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration - seconds);
+        return boost::posix_time::from_time_t(seconds.count()) + boost::posix_time::microseconds(microseconds.count());
+    }
+};
+
+// Hierarchical timing wheel serving all the Timers of a network with a single asio timer. Each wheel has one slot per
+// tick of the previous one, the first one a slot per tick of the clock. A timer is linked into the slot of the first
+// wheel covering its expiry, in O(1) and unlinked in O(1) when cancelled, and the slots of the outer wheels are
+// cascaded into the inner ones when the wheel reaches them. The asio timer is only armed for the next slot holding
+// timers, the timers then due being expired together.
+template <typename Network>
+class TimerWheel {
+    struct Link {
+        Link *prev = nullptr;
+        Link *next = nullptr;
+    };
+
+  public:
+    // Called with true once the timer expires, with false by the thread cancelling or rescheduling it first. The
+    // handler of a periodic timer is kept, and called with the wheel locked: it must only post work to the loop.
+    using Handler = InplaceFunction<void(bool), 64>;
+
+    // Owned by its Timer, only accessed by the wheel under its lock
+    class Entry : private Link {
+        friend class TimerWheel;
+
+        std::uint64_t expiry_ = 0;
+        std::uint64_t period_ = 0;
+        std::size_t level_ = 0;
+        Handler handler_;
+    };
+
+    explicit TimerWheel(boost::asio::io_context &io_context) : timer_{io_context}, current_{NowTick()}
+    {
+        for (auto &wheel : wheels_) {
+            for (auto &slot : wheel) {
+                slot.prev = slot.next = &slot;
+            }
+        }
+    }
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    // Replace the handler of the entry, if any, by one expiring after delay, then every period if not zero
+    void Schedule(Entry &entry, std::chrono::milliseconds delay, std::chrono::milliseconds period, Handler &&handler)
+    {
+        Handler replaced;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            replaced = Unlink(entry);
+            auto now = NowTick();
+            if (armed_ == 0) {
+                // Nothing can expire in between, follow the clock even if it was set back (e.g. in unit tests)
+                current_ = now;
+            }
+            entry.expiry_ = std::max(now + Ticks(delay), current_ + 1);
+            entry.period_ = Ticks(period);
+            entry.handler_ = std::move(handler);
+            Insert(entry);
+            ++armed_;
+            if (entry.expiry_ < armed_wake_ && !rearm_pending_) {
+                // The asio timer is only touched by the loop
+                rearm_pending_ = true;
+                boost::asio::post(timer_.get_executor(), [this] {
+                    std::lock_guard<std::mutex> lock{mutex_};
+                    rearm_pending_ = false;
+                    Arm();
+                });
+            }
+        }
+        if (replaced) {
+            replaced(false);
+        }
+    }
+
+    void Cancel(Entry &entry)
+    {
+        Handler cancelled;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            cancelled = Unlink(entry);
+        }
+        if (cancelled) {
+            cancelled(false);
+        }
+    }
+
+    // Hand the timer of an entry over to another one, in place in its slot. The timer of the target entry is cancelled.
+    void Move(Entry &from, Entry &to)
+    {
+        Handler cancelled;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            cancelled = Unlink(to);
+            if (from.next) {
+                to.prev = from.prev;
+                to.next = from.next;
+                to.prev->next = &to;
+                to.next->prev = &to;
+                from.prev = from.next = nullptr;
+                to.expiry_ = from.expiry_;
+                to.period_ = from.period_;
+                to.level_ = from.level_;
+                to.handler_ = std::move(from.handler_);
+            }
+        }
+        if (cancelled) {
+            cancelled(false);
+        }
+    }
+
+  private:
+    static constexpr std::size_t slot_bits = 8;
+    static constexpr std::size_t slot_count = std::size_t{1} << slot_bits;
+    static constexpr std::uint64_t slot_mask = slot_count - 1;
+    static constexpr std::size_t level_count = 4;
+    static constexpr std::uint64_t no_wake = std::numeric_limits<std::uint64_t>::max();
+    static constexpr std::uint64_t tick_ms = timer_tick_ms_or_default<Network>::value;
+
+    static boost::posix_time::ptime Epoch()
+    {
+        return boost::posix_time::ptime{boost::gregorian::date{1970, 1, 1}};
+    }
+
+    static std::uint64_t NowTick()
+    {
+        auto elapsed = (MockableClock::now() - Epoch()).total_milliseconds();
+        return elapsed > 0 ? static_cast<std::uint64_t>(elapsed) / tick_ms : 0;
+    }
+
+    static std::uint64_t Ticks(std::chrono::milliseconds duration)
     {
-        return io_context_;
+        return duration.count() > 0 ? (static_cast<std::uint64_t>(duration.count()) + tick_ms - 1) / tick_ms : 0;
+    }
+
+    static void LinkBack(Link &slot, Link &link)
+    {
+        link.prev = slot.prev;
+        link.next = &slot;
+        slot.prev->next = &link;
+        slot.prev = &link;
+    }
+
+    // Detach the timers of a slot, so that they can be relinked while walking them
+    static Link *Splice(Link &slot)
+    {
+        if (slot.next == &slot) {
+            return nullptr;
+        }
+        auto first = slot.next;
+        slot.prev->next = nullptr;
+        slot.prev = slot.next = &slot;
+        return first;
+    }
+
+    Handler Unlink(Entry &entry)
+    {
+        if (!entry.next) {
+            return nullptr;
+        }
+        entry.prev->next = entry.next;
+        entry.next->prev = entry.prev;
+        entry.prev = entry.next = nullptr;
+        --level_sizes_[entry.level_];
+        --armed_;
+        return std::move(entry.handler_);
+    }
+
+    // Link the entry into the innermost wheel covering its expiry. Expiries beyond the outermost wheel wait in the
+    // last slot it reaches, and are linked again from there.
+    void Insert(Entry &entry)
+    {
+        auto delta = entry.expiry_ - current_;
+        std::size_t level = 0;
+        while (level + 1 < level_count && delta >> (slot_bits * (level + 1))) {
+            ++level;
+        }
+        auto shift = slot_bits * level;
+        auto slot = (entry.expiry_ >> shift) & slot_mask;
+        if (delta >> (slot_bits * level_count)) {
+            slot = ((current_ >> shift) + slot_mask) & slot_mask;
+        }
+        entry.level_ = level;
+        ++level_sizes_[level];
+        LinkBack(wheels_[level][slot], entry);
+    }
+
+    // First tick after the current one reaching a slot holding timers
+    std::uint64_t NextTick() const
+    {
+        auto next = no_wake;
+        for (std::size_t level = 0; level < level_count; ++level) {
+            if (level_sizes_[level] == 0) {
+                continue;
+            }
+            auto shift = slot_bits * level;
+            auto position = current_ >> shift;
+            for (std::uint64_t step = 1; step <= slot_count; ++step) {
+                auto &slot = wheels_[level][(position + step) & slot_mask];
+                if (slot.next != &slot) {
+                    next = std::min(next, (position + step) << shift);
+                    break;
+                }
+            }
+        }
+        return next;
+    }
+
+    void Cascade(std::size_t level, std::uint64_t slot)
+    {
+        for (auto link = Splice(wheels_[level][slot]); link;) {
+            auto &entry = static_cast<Entry &>(*link);
+            link = link->next;
+            --level_sizes_[level];
+            Insert(entry);
+        }
+    }
+
+    void Expire(std::uint64_t slot)
+    {
+        for (auto link = Splice(wheels_[0][slot]); link;) {
+            auto &entry = static_cast<Entry &>(*link);
+            link = link->next;
+            --level_sizes_[0];
+            if (entry.period_ > 0) {
+                entry.expiry_ += entry.period_;
+                Insert(entry);
+                entry.handler_(true);
+            } else {
+                entry.prev = entry.next = nullptr;
+                --armed_;
+                expired_.push_back(std::move(entry.handler_));
+            }
+        }
+    }
+
+    // Move the wheel to the target tick, through the ticks reaching a slot holding timers
+    void Advance(std::uint64_t target)
+    {
+        while (armed_ > 0) {
+            auto tick = NextTick();
+            if (tick > target) {
+                break;
+            }
+            current_ = tick;
+            for (auto level = level_count - 1; level > 0; --level) {
+                auto shift = slot_bits * level;
+                if ((tick & ((std::uint64_t{1} << shift) - 1)) == 0) {
+                    Cascade(level, (tick >> shift) & slot_mask);
+                }
+            }
+            Expire(tick & slot_mask);
+        }
+        current_ = std::max(current_, target);
+    }
+
+    void Arm()
+    {
+        if (armed_ == 0) {
+            return;
+        }
+        auto wake = NextTick();
+        if (wake >= armed_wake_) {
+            return;
+        }
+        armed_wake_ = wake;
+        timer_.expires_at(Epoch() + boost::posix_time::milliseconds(wake * tick_ms));
+        timer_.async_wait([this](const boost::system::error_code &ec) {
+            if (ec == boost::asio::error::operation_aborted) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                armed_wake_ = no_wake;
+                Advance(NowTick());
+                Arm();
+            }
+            // Only the loop runs this handler, the expired timers are handed over out of the lock
+            for (auto &handler : expired_) {
+                handler(true);
+            }
+            expired_.clear();
+        });
+    }
+
+    std::mutex mutex_;
+    boost::asio::basic_deadline_timer<boost::posix_time::ptime, MockableClock> timer_;
+    std::array<std::array<Link, slot_count>, level_count> wheels_;
+    std::array<std::size_t, level_count> level_sizes_{};
+    std::uint64_t current_;
+    std::size_t armed_ = 0;
+    std::uint64_t armed_wake_ = no_wake;
+    bool rearm_pending_ = false;
+    std::vector<Handler> expired_;
+};
+
+// Callback of a periodic Timer, shared by the tasks posted at each interval
+template <typename Callback>
+struct PeriodicCallback {
+    explicit PeriodicCallback(Callback &&callback) : callback(std::move(callback))
+    {
+    }
+
+    Callback callback;
+    // Intervals elapsed and not run yet, the task posted for the first one also runs the ones elapsing meanwhile
+    std::atomic<std::size_t> pending{0};
+};
+
+inline void DeferReclaim(void (*reclaim)(std::chrono::milliseconds), std::chrono::milliseconds delay)
+{
+    auto timer = std::make_shared<boost::asio::steady_timer>(getEventLoop<RcuReclaimer>().GetIOContext(), delay);
+    timer->async_wait([timer, reclaim, delay](const boost::system::error_code &error) {
+        if (!error) {
+            reclaim(delay);
+        }
+    });
+}
+
+}  // namespace internal
+
+// ========================================= API ========================================= //
+
+/**
+ * @brief Attach a callable to a function signature.
+ *
+ * This function binds a callable (e.g., a lambda, function, or functor) to a specific function signature.
+ * The callable must match the return type and argument types defined by the function signature.
+ * The callable only needs to be movable. It is stored in place when it fits in `handler_storage_size` bytes (32 by
+ * default), which the function signature can declare, and on the heap otherwise.
+ * Attaching again replaces the handler atomically, also while other threads are calling it: calls already in flight
+ * finish on the previous callable, which is destroyed once they all returned, by a later attach or detach.
+ *
+ * @tparam FuncSignature The function signature to attach the callable to.
+ * @tparam Callable The type of the callable.
+ * @param callable The callable to attach.
+ *
+ * @note If the callable's return type does not match the function signature's return type, a static assertion will
+ * fail.
+ *
+ * Example:
+ * @code
+ * struct Addition {
+ *     using args_t = std::tuple<int, int>;
+ *     using return_t = int;
+ * };
+ *
+ * dispatcher::attach<Addition>([](int a, int b) { return a + b; });
+ * @endcode
+ */
+template <typename FuncSignature, typename Callable>
+void attach(Callable &&callable)
+{
+    static_assert(
+        std::is_same<typename internal::FunctionDispatcher<FuncSignature>::return_t,
+                     typename internal::ReturnTypeFromCallable<
+                         Callable, typename internal::FunctionDispatcher<FuncSignature>::args_t>::type>::value,
+        "The return values of the callable is not matching the function signature");
+    internal::FunctionDispatcher<FuncSignature>::template attach<Callable>(std::forward<Callable>(callable));
+}
+
+/**
+ * @brief Bind a function to a function signature at compile time.
+ *
+ * `dispatcher::call` on the signature then becomes a direct call to the function, which the compiler can inline: there
+ * is no type erasure, no lookup of the attached callable and no exception handling. Asynchronous calls also use the
+ * function. Only the declaration of the function needs to be visible, its implementation can live in any translation
+ * unit.
+ *
+ * The macro must be used at global scope, in a header included before any call to the signature. Such a signature
+ * cannot be attached nor detached at runtime.
+ *
+ * @param FuncSignature The function signature to bind the function to.
+ * @param handler_function A pointer to a function matching the signature.
+ *
+ * Example:
+ * @code
+ * struct Addition {
+ *     using args_t = std::tuple<int, int>;
+ *     using return_t = int;
+ * };
+ *
+ * int add(int a, int b);
+ * DISPATCHER_ATTACH_STATIC(Addition, &add);
+ *
+ * int result = dispatcher::call<Addition>(3, 5); // Calls add directly
+ * @endcode
+ */
+#define DISPATCHER_ATTACH_STATIC(FuncSignature, handler_function)   \
+    template <>                                                       \
+    struct dispatcher::internal::StaticHandler<FuncSignature> {       \
+        static constexpr auto function = handler_function;            \
     }
 
-  private:
-    boost::asio::io_context io_context_;
-    boost::asio::executor_work_guard<decltype(io_context_.get_executor())> work_guard_;
-    std::thread work_thread_;
-    std::vector<std::thread> additional_work_threads_;
-    std::atomic<bool> stopped_{false};
-    MemoryPool memory_pool_{30000};
-};
+/**
+ * @brief Detach the callable from a function signature.
+ *
+ * This function removes the callable that was previously attached to the specified function signature.
+ * After detaching, any calls to the function signature will throw an exception. Calls already in flight finish on the
+ * detached callable.
+ *
+ * @tparam FuncSignature The function signature to detach the callable from.
+ */
+template <typename FuncSignature>
+void detach()
+{
+    internal::FunctionDispatcher<FuncSignature>::detach();
+}
+
+/**
+ * @brief Call a function by its signature with the provided arguments.
+ *
+ * This function invokes the callable previously attached to the specified function signature with the given arguments.
+ * The arguments must match the types defined in the function signature.
+ * This function is blocking
+ *
+ * @tparam FuncSignature The function signature to call.
+ * @tparam Args The types of the arguments to pass to the callable.
+ * @param args The arguments to pass to the callable.
+ * @return The return value of the callable.
+ *
+ * @throws NoHandler<FuncSignature> If no callable is attached to the function signature.
+ *
+ * Example:
+ * @code
+ * struct Addition {
+ *     using args_t = std::tuple<int, int>;
+ *     using return_t = int;
+ * };
+ *
+ * dispatcher::attach<Addition>([](int a, int b) { return a + b; });
+ * int result = dispatcher::call<Addition>(3, 5); // result will be 8
+ * @endcode
+ */
+template <typename FuncSignature, typename... Args>
+auto call(Args &&...args)
+{
+    return internal::FunctionDispatcher<FuncSignature>::call(std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Perform an asynchronous function call by its signature with the provided arguments.
+ *
+ * This function invokes the callable attached to the specified function signature asynchronously.
+ * The arguments must match the types defined in the function signature. The function returns a
+ * `dispatcher::Future`, a `boost::fibers::future` that can be used to retrieve the result of the callable once it
+ * completes, or chained with a continuation (see `Future::then`, `when_all` and `when_any`).
+ *
+ * @tparam FuncSignature The function signature to call.
+ * @tparam Network The network type, aka wich EventLoop will handle this (default is `internal::Default`).
+ * @tparam Args The types of the arguments to pass to the callable.
+ * @param args The arguments to pass to the callable.
+ * @return A `Future` containing the return value of the callable. If no callable is attached, the
+ * future holds a NoHandler<FuncSignature> exception, and it holds the exception thrown by the callable if any.
+ *
+ * @note This function does not block the calling thread. The callable is executed in the context
+ * of the event loop associated with the specified network.
+ *
+ * Example
+ * @code
+ * struct Addition {
+ *     using args_t = std::tuple<int, int>;
+ *     using return_t = int;
+ * };
+ *
+ * dispatcher::attach<Addition>([](int a, int b) { return a + b; });
+ * auto future = dispatcher::async_call<Addition>(3, 5);
+ * int result = future.get(); // result will be 8
+ * @endcode
+ */
+template <typename FuncSignature, typename Network = internal::Default, typename... Args>
+auto async_call(Args &&...args)
+{
+    using dispatcher_t = internal::FunctionDispatcher<FuncSignature>;
+    return internal::PostCall<FuncSignature, Network, typename dispatcher_t::return_t>(
+        [](auto &&...args) -> typename dispatcher_t::return_t {
+            return dispatcher_t::call(std::forward<decltype(args)>(args)...);
+        },
+        std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Perform an asynchronous function call which is dropped if it is stale or cancelled when it is about to run.
+ *
+ * Same as async_call, except that the call is not run once the deadline of the options passed or their cancellation
+ * token is cancelled. The future then holds a DeadlineExceeded<FuncSignature> or Cancelled<FuncSignature> exception,
+ * and the call is counted by `get_dropped_call_stats`. This lets a backed-up event loop skip the calls nobody waits for
+ * anymore.
+ *
+ * @tparam FuncSignature The function signature to call.
+ * @tparam Network The network type, aka wich EventLoop will handle this (default is `internal::Default`).
+ * @tparam Args The types of the arguments to pass to the callable.
+ * @param options The deadline and cancellation token of the call, both optional.
+ * @param args The arguments to pass to the callable.
+ * @return A `Future` containing the return value of the callable.
+ *
+ * Example
+ * @code
+ * dispatcher::CancellationToken token;
+ * auto future = dispatcher::async_call<Addition>(
+ *     dispatcher::CallOptions{std::chrono::steady_clock::now() + std::chrono::milliseconds(50), token}, 3, 5);
+ * token.cancel();  // The future holds a dispatcher::Cancelled<Addition> exception unless the call already ran
+ * @endcode
+ */
+template <typename FuncSignature, typename Network = internal::Default, typename... Args>
+auto async_call(CallOptions options, Args &&...args)
+{
+    using dispatcher_t = internal::FunctionDispatcher<FuncSignature>;
+    using return_t = typename dispatcher_t::return_t;
+    return internal::PostCall<FuncSignature, Network, return_t>(
+        std::move(options),
+        [](auto &&...args) -> return_t { return dispatcher_t::call(std::forward<decltype(args)>(args)...); },
+        [](auto &promise, CallError reason) {
+            if (reason == CallError::Cancelled) {
+                promise.set_exception(std::make_exception_ptr(Cancelled<FuncSignature>{}));
+            } else {
+                promise.set_exception(std::make_exception_ptr(DeadlineExceeded<FuncSignature>{}));
+            }
+        },
+        std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Perform a batch of asynchronous function calls with a single post to the event loop.
+ *
+ * Posts one task which calls the attached callable once per element of the batch, in order, instead of posting one
+ * task, fiber and promise per call. The batch is a range of argument tuples, copied or moved into the task.
+ *
+ * @tparam FuncSignature The function signature to call.
+ * @tparam Network The network type, aka wich EventLoop will handle this (default is `internal::Default`).
+ * @tparam Range A range of tuples holding the arguments of each call, e.g. `std::vector<std::tuple<int, int>>`.
+ * @param batch The arguments of every call.
+ * @return A `Future` holding the vector of the return values, in the order of the batch, or
+ * `Future<void>` if the signature returns void. References are returned as `std::reference_wrapper`.
+ * The future holds the exception of the first call that throws, NoHandler<FuncSignature> if no callable is attached.
+ *
+ * Example
+ * @code
+ * std::vector<std::tuple<int, int>> batch{{1, 2}, {3, 4}};
+ * auto future = dispatcher::async_call_batch<Addition>(std::move(batch));
+ * std::vector<int> results = future.get(); // {3, 7}
+ * @endcode
+ */
+template <typename FuncSignature, typename Network = internal::Default, typename Range>
+auto async_call_batch(Range &&batch)
+{
+    using dispatcher_t = internal::FunctionDispatcher<FuncSignature>;
+    using return_t = typename dispatcher_t::return_t;
+    using element_t = std::conditional_t<std::is_reference<return_t>::value,
+                                         std::reference_wrapper<std::remove_reference_t<return_t>>, return_t>;
+    using results_t = std::conditional_t<std::is_void<return_t>::value, void, std::vector<element_t>>;
+    return internal::PostCall<FuncSignature, Network, results_t>(
+        [](auto &&batch) -> results_t {
+            auto call = [](auto &&...args) -> return_t {
+                return dispatcher_t::call(std::forward<decltype(args)>(args)...);
+            };
+            if constexpr (std::is_void<return_t>::value) {
+                for (auto &args : batch) {
+                    std::apply(call, std::move(args));
+                }
+            } else {
+                results_t results;
+                if constexpr (std::ranges::sized_range<decltype(batch)>) {
+                    results.reserve(std::ranges::size(batch));
+                }
+                for (auto &args : batch) {
+                    results.push_back(std::apply(call, std::move(args)));
+                }
+                return results;
+            }
+        },
+        std::forward<Range>(batch));
+}
+
+/**
+ * @brief Call a function by its signature, reporting a missing handler in the result instead of throwing.
+ *
+ * Same as call, but the absence of a handler is checked with a branch and returned as CallError::NoHandler, without
+ * any exception being thrown and unwound. Exceptions thrown by the callable itself still propagate.
+ * This function is blocking
+ *
+ * @tparam FuncSignature The function signature to call.
+ * @tparam Args The types of the arguments to pass to the callable.
+ * @param args The arguments to pass to the callable.
+ * @return A CallResult holding the return value of the callable, or CallError::NoHandler.
+ *
+ * Example:
+ * @code
+ * if (auto result = dispatcher::try_call<Addition>(3, 5)) {
+ *     int sum = *result; // 8
+ * }
+ * @endcode
+ */
+template <typename FuncSignature, typename... Args>
+auto try_call(Args &&...args)
+{
+    return internal::FunctionDispatcher<FuncSignature>::try_call(std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Perform an asynchronous function call, reporting a missing handler in the result instead of throwing.
+ *
+ * Same as async_call, but the future holds a CallResult, which is CallError::NoHandler if no callable is attached
+ * when the call is executed. An exception thrown by the callable is stored in the future.
+ *
+ * @tparam FuncSignature The function signature to call.
+ * @tparam Network The network type, aka wich EventLoop will handle this (default is `internal::Default`).
+ * @tparam Args The types of the arguments to pass to the callable.
+ * @param args The arguments to pass to the callable.
+ * @return A `Future` containing a CallResult.
+ */
+template <typename FuncSignature, typename Network = internal::Default, typename... Args>
+auto try_async_call(Args &&...args)
+{
+    using dispatcher_t = internal::FunctionDispatcher<FuncSignature>;
+    using result_t = CallResult<typename dispatcher_t::return_t>;
+    return internal::PostCall<FuncSignature, Network, result_t>(
+        [](auto &&...args) -> result_t { return dispatcher_t::try_call(std::forward<decltype(args)>(args)...); },
+        std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Same as the async_call taking CallOptions, the dropped call being reported in the CallResult.
+ *
+ * @return A `Future` containing a CallResult, which is CallError::DeadlineExceeded or
+ * CallError::Cancelled if the call was dropped.
+ */
+template <typename FuncSignature, typename Network = internal::Default, typename... Args>
+auto try_async_call(CallOptions options, Args &&...args)
+{
+    using dispatcher_t = internal::FunctionDispatcher<FuncSignature>;
+    using result_t = CallResult<typename dispatcher_t::return_t>;
+    return internal::PostCall<FuncSignature, Network, result_t>(
+        std::move(options),
+        [](auto &&...args) -> result_t { return dispatcher_t::try_call(std::forward<decltype(args)>(args)...); },
+        [](auto &promise, CallError reason) { promise.set_value(result_t{reason}); },
+        std::forward<Args>(args)...);
+}
 
-template <typename Network = Default>
-EventLoop<Network> &getEventLoop()
+/**
+ * @brief Combine futures into one holding all of their results, without any fiber waiting for them.
+ *
+ * The combined future is fulfilled by the thread completing the last of the futures. A void result is held as
+ * `std::nullptr_t` and a reference as a `std::reference_wrapper`.
+ *
+ * @tparam T The result types of the futures.
+ * @param futures The futures to combine, e.g. returned by `async_call` or `then`.
+ * @return A Future holding the tuple of the results, in order, or the first exception held by one of the futures.
+ *
+ * Example
+ * @code
+ * dispatcher::when_all(dispatcher::async_call<Addition>(1, 2), dispatcher::async_call<Multiplication>(3, 4))
+ *     .then([](std::tuple<int, int> results) { std::cout << std::get<0>(results) + std::get<1>(results); });  // 15
+ * @endcode
+ */
+template <typename... T>
+Future<std::tuple<internal::combined_t<T>...>> when_all(Future<T>... futures)
 {
-    static EventLoop<Network> event_loop;
-    return event_loop;
+    auto state = std::make_shared<internal::WhenAllState<internal::TupleResults<T...>>>(internal::TupleResults<T...>{},
+                                                                                         sizeof...(T));
+    auto combined = state->GetFuture();
+    if constexpr (sizeof...(T) == 0) {
+        state->Complete([](auto &) {});
+    } else {
+        std::tuple<Future<T>...> pending{std::move(futures)...};
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (internal::OnReady(std::move(std::get<Is>(pending)),
+                               [state](auto &future) {
+                                   state->Complete([&](auto &results) {
+                                       std::get<Is>(results.results).emplace(internal::GetCombined(future));
+                                   });
+                               }),
+             ...);
+        }(std::index_sequence_for<T...>{});
+    }
+    return combined;
 }
 
-template <typename F, typename Tuple, std::size_t... Is>
-auto call_with_tuple(F &&f, Tuple &&t, std::index_sequence<Is...>)
+/**
+ * @brief Same as the variadic when_all, for any number of futures of the same type.
+ *
+ * @return A Future holding the vector of the results, in the order of the futures.
+ */
+template <typename T>
+Future<std::vector<internal::combined_t<T>>> when_all(std::vector<Future<T>> futures)
 {
-    return f(std::get<Is>(std::forward<Tuple>(t))...);
+    internal::VectorResults<T> results;
+    results.results.resize(futures.size());
+    auto state =
+        std::make_shared<internal::WhenAllState<internal::VectorResults<T>>>(std::move(results), futures.size());
+    auto combined = state->GetFuture();
+    if (futures.empty()) {
+        state->Complete([](auto &) {});
+    }
+    for (std::size_t i = 0; i < futures.size(); ++i) {
+        internal::OnReady(std::move(futures[i]), [state, i](auto &future) {
+            state->Complete([&](auto &results) { results.results[i].emplace(internal::GetCombined(future)); });
+        });
+    }
+    return combined;
 }
 
-template <typename F, typename Tuple>
-auto call_with_tuple(F &&f, Tuple &&t)
+/**
+ * @brief Result of when_any.
+ */
+template <typename T>
+struct WhenAnyResult {
+    std::size_t index;  ///< Index of the first future to complete
+    T value;            ///< Its result
+};
+
+/**
+ * @brief Combine futures into one holding the result of the first of them to complete, without any fiber waiting.
+ *
+ * The results of the other futures are discarded once they complete. A void result is held as `std::nullptr_t` and a
+ * reference as a `std::reference_wrapper`.
+ *
+ * @tparam T The result type of the futures.
+ * @param futures The futures to combine, which must not be empty.
+ * @return A Future holding the index and result of the first future to complete, or its exception.
+ *
+ * Example
+ * @code
+ * std::vector<dispatcher::Future<Position>> fixes;
+ * fixes.push_back(dispatcher::async_call<GnssFix>());
+ * fixes.push_back(dispatcher::async_call<DeadReckoningFix>());
+ * auto first = dispatcher::when_any(std::move(fixes)).get();  // first.index tells which one answered first
+ * @endcode
+ */
+template <typename T>
+Future<WhenAnyResult<internal::combined_t<T>>> when_any(std::vector<Future<T>> futures)
 {
-    constexpr auto size = std::tuple_size<std::decay_t<Tuple>>::value;
-    return call_with_tuple(std::forward<F>(f), std::forward<Tuple>(t), std::make_index_sequence<size>{});
+    BOOST_ASSERT_MSG(!futures.empty(), "when_any needs at least one future");
+    using result_t = WhenAnyResult<internal::combined_t<T>>;
+    struct State {
+        std::atomic<bool> completed{false};
+        boost::fibers::promise<result_t> promise;
+        std::shared_ptr<internal::ContinuationSlot> slot = std::make_shared<internal::ContinuationSlot>();
+    };
+    auto state = std::make_shared<State>();
+    Future<result_t> combined{state->promise.get_future(), state->slot};
+    for (std::size_t i = 0; i < futures.size(); ++i) {
+        internal::OnReady(std::move(futures[i]), [state, i](auto &future) {
+            if (state->completed.exchange(true, std::memory_order_acq_rel)) {
+                return;
+            }
+            internal::FulfillPromise(state->promise, [&] { return result_t{i, internal::GetCombined(future)}; });
+            state->slot->Ready();
+        });
+    }
+    return combined;
 }
 
-template <typename EventSignature, typename Network, typename signal_type>
-signal_type &GetSignal()
+namespace internal {
+
+// Coroutines are resumed by the event loop of the network they were spawned on, as non-suspending tasks
+template <typename Network>
+void ResumeOn(std::coroutine_handle<> handle)
 {
-    static signal_type signal;
-    return signal;
+    getEventLoop<Network>().template Post<Execution::Inline>([handle] { handle.resume(); });
 }
 
-template <typename EventSignature, typename Network = internal::Default>
-struct EventDispatcher {
-    template <typename Callable>
-    static boost::signals2::connection subscribe(Callable &&callable)
+// Transfers to the awaiting coroutine, if any, once the coroutine completes
+struct FinalAwaiter {
+    bool await_ready() noexcept
     {
-        return GetSignal<EventSignature, Network, signal_type>().connect(std::forward<Callable>(callable));
+        return false;
     }
 
-    template <typename... Parameters>
-    static void publish(Parameters &&...parameters)
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
     {
-        auto parametersTuple = std::make_tuple(std::forward<Parameters>(parameters)...);
-        getEventLoop<Network>().Post([parametersTuple = std::move(parametersTuple)]() mutable {
-            call_with_tuple(GetSignal<EventSignature, Network, signal_type>(), std::move(parametersTuple));
-        });
+        auto continuation = handle.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
     }
 
-    using parameters_t =
-        typename parameters_t_or_default<EventSignature, has_parameters_t<EventSignature>::value>::type;
-
-    using signal_type = typename SignalFromTuple<parameters_t>::type;
+    void await_resume() noexcept
+    {
+    }
 };
 
-inline boost::optional<boost::asio::deadline_timer::traits_type::time_type> &Now()
-{
-    static boost::optional<boost::asio::deadline_timer::traits_type::time_type> now;
-    return now;
-}
-
-// This clock can be settable in unit test
-struct MockableClock {
-    typedef boost::asio::deadline_timer::traits_type source_traits;
-
-  public:
-    typedef source_traits::time_type time_type;
-    typedef source_traits::duration_type duration_type;
+struct CoroutinePromiseBase {
+    std::suspend_always initial_suspend() noexcept
+    {
+        return {};
+    }
 
-    static time_type now()
+    FinalAwaiter final_suspend() noexcept
     {
-        if (Now()) {
-            return *Now();
-        }
+        return {};
+    }
 
-        return chrono_to_ptime(std::chrono::system_clock::now());
+    void unhandled_exception()
+    {
+        exception = std::current_exception();
     }
 
-    // To be used in testing only
+    void (*resume)(std::coroutine_handle<>) = nullptr;
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+};
 
-    static void set_now(time_type t = chrono_to_ptime(std::chrono::system_clock::now()))
+template <typename T>
+struct CoroutinePromise : CoroutinePromiseBase {
+    template <typename U>
+    void return_value(U &&value)
     {
-        Now() = t;
+        result.emplace(std::forward<U>(value));
     }
 
-    template <typename Duration>
-    static void advance_time(Duration &&d)
+    T Result()
     {
-        if (!Now()) {
-            return;
+        if (exception) {
+            std::rethrow_exception(exception);
         }
-        *Now() = add(*Now(),
-                     boost::posix_time::milliseconds(std::chrono::duration_cast<std::chrono::milliseconds>(d).count()));
-        std::this_thread::sleep_for(std::chrono::microseconds(1100));
+        return std::move(*result);
     }
 
-    static time_type add(time_type t, duration_type d)
+    std::optional<T> result;
+};
+
+template <>
+struct CoroutinePromise<void> : CoroutinePromiseBase {
+    void return_void()
     {
-        return source_traits::add(t, d);
     }
-    static duration_type subtract(time_type t1, time_type t2)
+
+    void Result()
     {
-        return source_traits::subtract(t1, t2);
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
     }
-    static bool less_than(time_type t1, time_type t2)
+};
+
+// Resumes the awaiting coroutine once the Future is ready, instead of blocking a fiber
+template <typename T>
+class FutureAwaiter {
+  public:
+    explicit FutureAwaiter(Future<T> &&future) : future_(std::move(future))
     {
-        return source_traits::less_than(t1, t2);
     }
 
-    static boost::posix_time::time_duration to_posix_duration(duration_type d)
+    bool await_ready() const noexcept
     {
-        if (!Now()) {
-            return d;
-        }
-        return d < boost::posix_time::milliseconds(1) ? d : boost::posix_time::milliseconds(1);
+        return false;
     }
 
-    static boost::posix_time::ptime chrono_to_ptime(const std::chrono::system_clock::time_point &tp)
+    template <typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> handle)
     {
-        auto duration = tp.time_since_epoch();
-        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(duration);
-        auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration - seconds);
-        return boost::posix_time::from_time_t(seconds.count()) + boost::posix_time::microseconds(microseconds.count());
+        static_assert(std::is_base_of<CoroutinePromiseBase, Promise>::value,
+                      "Futures can only be awaited by a dispatcher::Coroutine");
+        OnReady(std::move(future_), [this, handle](boost::fibers::future<T> &ready) {
+            ready_ = std::move(ready);
+            handle.promise().resume(handle);
+        });
     }
+
+    T await_resume()
+    {
+        return ready_.get();
+    }
+
+  private:
+    Future<T> future_;
+    boost::fibers::future<T> ready_;
 };
 
 }  // namespace internal
 
-// ========================================= API ========================================= //
-
 /**
- * @brief Attach a callable to a function signature.
+ * @brief Stackless coroutine run by an event loop, as an alternative to a task running in its own fiber.
  *
- * This function binds a callable (e.g., a lambda, function, or functor) to a specific function signature.
- * The callable must match the return type and argument types defined by the function signature.
- *
- * @tparam FuncSignature The function signature to attach the callable to.
- * @tparam Callable The type of the callable.
- * @param callable The callable to attach.
+ * A coroutine does not start until it is spawned on a network with `spawn`, or awaited by another coroutine. It is
+ * resumed by the event loop of the network as a non-suspending task, so it must not block: it awaits the futures of
+ * the asynchronous calls (`co_await dispatcher::async_call<Sig>(...)`), `expect`, `Timer::After` and the other
+ * coroutines instead. Its frame only holds the variables living across the suspension points, which is much smaller
+ * than the stack of a fiber.
  *
- * @note If the callable's return type does not match the function signature's return type, a static assertion will
- * fail.
+ * @tparam T The type returned by the coroutine with `co_return`, not a reference.
  *
- * Example:
+ * Example
  * @code
- * struct Addition {
- *     using args_t = std::tuple<int, int>;
- *     using return_t = int;
- * };
+ * dispatcher::Coroutine<int> AddThenMultiply(int a, int b)
+ * {
+ *     int sum = co_await dispatcher::async_call<Addition>(a, b);
+ *     co_await dispatcher::DefaultTimer{}.After(std::chrono::milliseconds(10));
+ *     co_return co_await dispatcher::async_call<Multiplication>(sum, 10);
+ * }
  *
- * dispatcher::attach<Addition>([](int a, int b) { return a + b; });
+ * int result = dispatcher::spawn(AddThenMultiply(1, 2)).get();  // 30
  * @endcode
  */
-template <typename FuncSignature, typename Callable>
-void attach(Callable &&callable)
-{
-    static_assert(
-        std::is_same<typename internal::FunctionDispatcher<FuncSignature>::return_t,
-                     typename internal::ReturnTypeFromCallable<
-                         Callable, typename internal::FunctionDispatcher<FuncSignature>::args_t>::type>::value,
-        "The return values of the callable is not matching the function signature");
-    internal::FunctionDispatcher<FuncSignature>::template attach<Callable>(std::forward<Callable>(callable));
-}
+template <typename T = void>
+class [[nodiscard]] Coroutine {
+    static_assert(!std::is_reference<T>::value, "Coroutines cannot return references");
+
+  public:
+    struct promise_type : internal::CoroutinePromise<T> {
+        Coroutine get_return_object()
+        {
+            return Coroutine{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+    };
+
+    explicit Coroutine(std::coroutine_handle<promise_type> handle) : handle_(handle)
+    {
+    }
+
+    Coroutine(Coroutine &&other) noexcept : handle_(std::exchange(other.handle_, {}))
+    {
+    }
+
+    Coroutine &operator=(Coroutine &&other) noexcept
+    {
+        std::swap(handle_, other.handle_);
+        return *this;
+    }
+
+    Coroutine(const Coroutine &) = delete;
+    Coroutine &operator=(const Coroutine &) = delete;
+
+    ~Coroutine()
+    {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    // Runs on the event loop of the awaiting coroutine, which is resumed as soon as this one completes
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> awaiting) noexcept
+    {
+        handle_.promise().resume = awaiting.promise().resume;
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+
+    T await_resume()
+    {
+        return handle_.promise().Result();
+    }
+
+  private:
+    std::coroutine_handle<promise_type> handle_;
+};
 
 /**
- * @brief Detach the callable from a function signature.
- *
- * This function removes the callable that was previously attached to the specified function signature.
- * After detaching, any calls to the function signature will throw an exception.
- *
- * @tparam FuncSignature The function signature to detach the callable from.
+ * @brief Await a Future from a Coroutine, without blocking the event loop.
  */
-template <typename FuncSignature>
-void detach()
+template <typename T>
+internal::FutureAwaiter<T> operator co_await(Future<T> &&future)
 {
-    internal::FunctionDispatcher<FuncSignature>::detach();
+    return internal::FutureAwaiter<T>{std::move(future)};
 }
 
-/**
- * @brief Call a function by its signature with the provided arguments.
- *
- * This function invokes the callable previously attached to the specified function signature with the given arguments.
- * The arguments must match the types defined in the function signature.
- * This function is blocking
- *
- * @tparam FuncSignature The function signature to call.
- * @tparam Args The types of the arguments to pass to the callable.
- * @param args The arguments to pass to the callable.
- * @return The return value of the callable.
- *
- * @throws NoHandler<FuncSignature> If no callable is attached to the function signature.
- *
- * Example:
- * @code
- * struct Addition {
- *     using args_t = std::tuple<int, int>;
- *     using return_t = int;
- * };
- *
- * dispatcher::attach<Addition>([](int a, int b) { return a + b; });
- * int result = dispatcher::call<Addition>(3, 5); // result will be 8
- * @endcode
- */
-template <typename FuncSignature, typename... Args>
-auto call(Args &&...args)
+namespace internal {
+
+// Owns itself, its frame is destroyed once it completes
+struct DetachedCoroutine {
+    struct promise_type : CoroutinePromiseBase {
+        DetachedCoroutine get_return_object()
+        {
+            return DetachedCoroutine{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void()
+        {
+        }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+template <typename T>
+DetachedCoroutine RunSpawned(Coroutine<T> coroutine,
+                             boost::fibers::promise<T> promise,
+                             std::shared_ptr<ContinuationSlot> slot)
 {
-    return internal::FunctionDispatcher<FuncSignature>::call(std::forward<Args>(args)...);
+    try {
+        if constexpr (std::is_void<T>::value) {
+            co_await std::move(coroutine);
+            promise.set_value();
+        } else {
+            promise.set_value(co_await std::move(coroutine));
+        }
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+    slot->Ready();
 }
 
-/**
- * @brief Perform an asynchronous function call by its signature with the provided arguments.
- *
- * This function invokes the callable attached to the specified function signature asynchronously.
- * The arguments must match the types defined in the function signature. The function returns a
- * `boost::fibers::future` that can be used to retrieve the result of the callable once it completes.
- *
- * @tparam FuncSignature The function signature to call.
- * @tparam Network The network type, aka wich EventLoop will handle this (default is `internal::Default`).
- * @tparam Args The types of the arguments to pass to the callable.
- * @param args The arguments to pass to the callable.
- * @return A `boost::fibers::future` containing the return value of the callable.
- *
- * @throws NoHandler<FuncSignature> If no callable is attached to the function signature.
+}  // namespace internal
+
+/**
+ * @brief Start a coroutine on the event loop of a network.
  *
- * @note This function does not block the calling thread. The callable is executed in the context
- * of the event loop associated with the specified network.
+ * @tparam Network The network whose event loop runs the coroutine (default is `internal::Default`).
+ * @tparam T The type returned by the coroutine.
+ * @param coroutine The coroutine to start.
+ * @return A Future holding what the coroutine returns, or the exception it throws.
  *
  * Example
  * @code
- * struct Addition {
- *     using args_t = std::tuple<int, int>;
- *     using return_t = int;
- * };
+ * dispatcher::Coroutine<> WaitForStart()
+ * {
+ *     co_await dispatcher::expect<EngineStarted>();
+ *     std::cout << "Engine started" << std::endl;
+ * }
  *
- * dispatcher::attach<Addition>([](int a, int b) { return a + b; });
- * auto future = dispatcher::async_call<Addition>(3, 5);
- * int result = future.get(); // result will be 8
+ * dispatcher::spawn<VehicleNetwork>(WaitForStart());
  * @endcode
  */
-template <typename FuncSignature, typename Network = internal::Default, typename... Args>
-auto async_call(Args &&...args)
+template <typename Network = internal::Default, typename T>
+Future<T> spawn(Coroutine<T> coroutine)
 {
-    boost::fibers::promise<typename internal::FunctionDispatcher<FuncSignature>::return_t> promise;
-    auto future = promise.get_future();
-
-    using func_type = typename internal::FunctionDispatcher<FuncSignature>::func_type;
-
-    auto argsTuple = std::make_tuple(std::forward<Args>(args)...);
-    internal::getEventLoop<Network>().Post([promise = std::move(promise), argsTuple = std::move(argsTuple)]() mutable {
-        promise.set_value(
-            internal::call_with_tuple(internal::GetFunction<FuncSignature, func_type>(), std::move(argsTuple)));
-    });
+    boost::fibers::promise<T> promise;
+    auto slot = std::make_shared<internal::ContinuationSlot>();
+    Future<T> future{promise.get_future(), slot};
+    auto detached = internal::RunSpawned(std::move(coroutine), std::move(promise), std::move(slot));
+    detached.handle.promise().resume = &internal::ResumeOn<Network>;
+    internal::ResumeOn<Network>(detached.handle);
     return future;
 }
 
@@ -552,13 +5244,14 @@ auto async_call(Args &&...args)
  * @brief Subscribe to an event with a callable.
  *
  * This function allows you to subscribe to an event by providing a callable (e.g., a lambda, function, or functor).
- * The callable will be invoked whenever the event is published.
+ * The callable will be invoked whenever the event is published. It only needs to be movable. Subscribing and
+ * disconnecting are safe while the event is being dispatched, which never takes a lock.
  *
  * @tparam EventSignature The event signature of the event to subscribe to.
  * @tparam Network The network type, aka which event loop will handle this (default is `internal::Default`).
  * @tparam Callable The type of the callable.
  * @param callable The callable to invoke when the event is published.
- * @return A `boost::signals2::connection` object representing the subscription.
+ * @return A `Connection` representing the subscription.
  *
  * Example:
  * @code
@@ -572,11 +5265,81 @@ auto async_call(Args &&...args)
  * @endcode
  */
 template <typename EventSignature, typename Network = internal::Default, typename Callable>
-boost::signals2::connection subscribe(Callable &&callable)
+Connection subscribe(Callable &&callable)
 {
     return internal::EventDispatcher<EventSignature, Network>::subscribe(std::forward<Callable>(callable));
 }
 
+/**
+ * @brief Subscribe to the events published with a given key.
+ *
+ * Keyed events declare a `key_t`, and are published with their key as first argument. Their subscribers are indexed by
+ * key, so that a publish only reaches the subscribers of its key, and the ones subscribed without key, which receive
+ * every event. The callable receives the parameters of the event, without the key.
+ *
+ * @tparam EventSignature The event signature of the event to subscribe to, which must declare a `key_t`.
+ * @tparam Network The network type, aka which event loop will handle this (default is `internal::Default`).
+ * @param key The key of the events to receive.
+ * @param callable The callable to invoke when an event is published with the key.
+ * @return A `Connection` representing the subscription.
+ *
+ * Example:
+ * @code
+ * struct VehicleSignal {
+ *     using key_t = std::uint32_t;
+ *     using parameters_t = std::tuple<double>;
+ * };
+ *
+ * dispatcher::subscribe<VehicleSignal>(kSpeed, [](double speed) { ... });
+ * dispatcher::publish<VehicleSignal>(kSpeed, 42.0);
+ * @endcode
+ */
+template <typename EventSignature, typename Network = internal::Default, typename Key, typename Callable>
+Connection subscribe(Key &&key, Callable &&callable)
+{
+    return internal::EventDispatcher<EventSignature, Network>::subscribe(std::forward<Key>(key),
+                                                                        std::forward<Callable>(callable));
+}
+
+/**
+ * @brief Value type of one event in a batch: the decayed parameter of the event signature, or a `std::tuple` of its
+ * decayed parameters when it has several.
+ */
+template <typename EventSignature, typename Network = internal::Default>
+using event_t = typename internal::EventDispatcher<EventSignature, Network>::event_t;
+
+/**
+ * @brief Subscribe to an event with a callable receiving whole batches of events.
+ *
+ * The callable receives every batch published with `publish_batch` at once, as a `std::span<const event_t>`, and each
+ * event published with `publish` as a span of one. If the event signature declares `columnar_batch = true`, which
+ * requires trivially copyable parameters, the events are laid out as one column per parameter instead, and the callable
+ * receives one `std::span` per parameter.
+ *
+ * @tparam EventSignature The event signature of the event to subscribe to.
+ * @tparam Network The network type, aka which event loop will handle this (default is `internal::Default`).
+ * @tparam Callable The type of the callable.
+ * @param callable The callable to invoke with each batch.
+ * @return A `Connection` representing the subscription.
+ *
+ * Example:
+ * @code
+ * struct Sample {
+ *     using parameters_t = std::tuple<int, float>;
+ *     static constexpr bool columnar_batch = true;
+ * };
+ *
+ * dispatcher::subscribe_batch<Sample>([](std::span<const int> ids, std::span<const float> values) {
+ *     // vectorizable loops over values
+ * });
+ * @endcode
+ */
+template <typename EventSignature, typename Network = internal::Default, typename Callable>
+Connection subscribe_batch(Callable &&callable)
+{
+    return internal::EventDispatcher<EventSignature, Network>::subscribe_batch(std::forward<Callable>(callable));
+}
+
 /**
  * @brief Wait for an event to be published.
  *
@@ -586,7 +5349,8 @@ boost::signals2::connection subscribe(Callable &&callable)
  *
  * @tparam EventSignature The event signature of the event to wait for.
  * @tparam Network The network type (default is `internal::Default`).
- * @return A `boost::fibers::future<std::nullptr_t>` that will be fulfilled when the event is published.
+ * @return A `Future<std::nullptr_t>` that will be fulfilled when the event is published, and can be awaited by a
+ * Coroutine.
  *
  * Example:
  * @code
@@ -600,16 +5364,25 @@ boost::signals2::connection subscribe(Callable &&callable)
  * @endcode
  */
 template <typename EventSignature, typename Network = internal::Default>
-boost::fibers::future<std::nullptr_t> expect()
+Future<std::nullptr_t> expect()
 {
     auto promise = std::make_shared<boost::fibers::promise<std::nullptr_t>>();
-    auto future = promise->get_future();
+    auto slot = std::make_shared<internal::ContinuationSlot>();
+    Future<std::nullptr_t> future{promise->get_future(), slot};
 
-    auto connection = std::make_shared<boost::signals2::connection>();
-    *connection = internal::EventDispatcher<EventSignature, Network>::subscribe([promise, connection](auto...) mutable {
-        connection->disconnect();
-        promise->set_value({});
-    });
+    auto connection = std::make_shared<Connection>();
+    *connection =
+        internal::EventDispatcher<EventSignature, Network>::subscribe([promise, slot, connection](auto...) mutable {
+            if (!promise) {
+                return;
+            }
+            connection->disconnect();
+            promise->set_value({});
+            slot->Ready();
+            // The disconnected slot outlives this call, release what it holds while the loop is still running
+            promise.reset();
+            connection.reset();
+        });
 
     return future;
 }
@@ -625,7 +5398,7 @@ boost::fibers::future<std::nullptr_t> expect()
  * @tparam Network The network type (default is `internal::Default`).
  * @tparam Callable The type of the callable.
  * @param callable The callable to invoke when the event is published.
- * @return A `boost::fibers::future<std::nullptr_t>` that will be fulfilled after the callable is executed.
+ * @return A `Future<std::nullptr_t>` that will be fulfilled after the callable is executed.
  *
  * Example:
  * @code
@@ -641,17 +5414,24 @@ boost::fibers::future<std::nullptr_t> expect()
  * @endcode
  */
 template <typename EventSignature, typename Network = internal::Default, typename Callable>
-boost::fibers::future<std::nullptr_t> expect(Callable &&callable)
+Future<std::nullptr_t> expect(Callable &&callable)
 {
     auto promise = std::make_shared<boost::fibers::promise<std::nullptr_t>>();
-    auto future = promise->get_future();
+    auto slot = std::make_shared<internal::ContinuationSlot>();
+    Future<std::nullptr_t> future{promise->get_future(), slot};
 
-    auto connection = std::make_shared<boost::signals2::connection>();
+    auto connection = std::make_shared<Connection>();
     *connection = internal::EventDispatcher<EventSignature, Network>::subscribe(
-        [promise, callable = std::forward<Callable>(callable), connection](auto &&...parameters) mutable {
+        [promise, slot, callable = std::forward<Callable>(callable), connection](auto &&...parameters) mutable {
+            if (!promise) {
+                return;
+            }
             connection->disconnect();
             callable(std::forward<decltype(parameters)>(parameters)...);
             promise->set_value({});
+            slot->Ready();
+            promise.reset();
+            connection.reset();
         });
 
     return future;
@@ -663,10 +5443,32 @@ boost::fibers::future<std::nullptr_t> expect(Callable &&callable)
  * This function triggers an event by its function signature and passes the provided arguments
  * to all subscribed callables. The event is handled asynchronously by the associated event loop.
  *
+ * Events declaring a `key_t` take their key as first argument, and only reach the subscribers of that key (see the
+ * keyed `subscribe`) besides the ones subscribed without key.
+ * By-value parameters are copied for each subscriber. Large payloads should be declared as `Shared<T>`, which is
+ * shared by all of them, and an event signature declaring `zero_copy = true` fails to compile if any of its parameters
+ * would be copied per subscriber.
+ *
+ * Events are queued without limit unless the event signature, or its network, declares an `event_queue_bound`. The
+ * events of such a signature waiting for the event loop are then limited to the bound, and the `overflow_policy` of
+ * the signature, or network, decides what happens to the events published while the queue is full:
+ * `OverflowPolicy::DropNewest` (default) drops the published event, `DropOldest` drops the oldest queued one, `Fail`
+ * throws `EventQueueFull<EventSignature>`, and `Block` suspends the publisher until an event is taken from the queue.
+ * Blocking is opt-in: it deadlocks the publishers the event loop has to run before it can drain the queue. Publishers
+ * that cannot be suspended, non-suspending tasks and the event loop thread outside of a fiber, get
+ * `EventQueueFull<EventSignature>` instead. See `get_event_queue_stats` for the counters.
+ *
+ * An event signature declaring `conflate = true` only keeps the value published last instead: publishing overwrites
+ * the value still waiting for the event loop, which is then delivered once. Its queue bound is ignored, and the value
+ * can be read at any time with `get_latest`. Values whose parameters are all trivially copyable are published without
+ * lock, other values are copied under a mutex.
+ *
  * @tparam EventDispatcher The function signature of the event to publish.
  * @tparam Network The network type (default is `internal::Default`).
  * @tparam Parameters The types of the parameters to pass to the event.
  * @param parameters The parameters to pass to the event.
+ * @throws EventQueueFull<EventSignature> If the bounded queue of the event is full and its policy is `Fail`, or `Block`
+ * while the publisher cannot be suspended.
  *
  * Example
  * @code
@@ -687,6 +5489,106 @@ void publish(Parameters &&...parameters)
     internal::EventDispatcher<EventSignature, Network>::publish(std::forward<Parameters>(parameters)...);
 }
 
+/**
+ * @brief Publish an event through the ingress queue of the network without blocking nor allocating.
+ *
+ * Same as `publish`, except that the event is pushed to the ingress queue of the network (see `try_post`) and is
+ * dropped if the queue is full.
+ *
+ * Events with a bounded queue (see `publish`) go through that queue instead, and never block: the event is rejected
+ * when the queue is full, unless the policy is `DropOldest`. The network then does not need an ingress queue.
+ *
+ * @tparam EventSignature The event signature of the event to publish.
+ * @tparam Network The network type, which must declare `ingress_queue_capacity` unless the event queue is bounded.
+ * @tparam Parameters The types of the parameters to pass to the event.
+ * @param parameters The parameters to pass to the event.
+ * @return `PostStatus::Posted` if the event was queued, `PostStatus::QueueFull` otherwise.
+ */
+template <typename EventSignature, typename Network, typename... Parameters>
+PostStatus try_publish(Parameters &&...parameters)
+{
+    return internal::EventDispatcher<EventSignature, Network>::try_publish(std::forward<Parameters>(parameters)...);
+}
+
+/**
+ * @brief Publish a batch of events with a single task on the event loop.
+ *
+ * The batch is copied into one task instead of posting one task per event. The batch subscribers receive all the
+ * events at once (see `subscribe_batch`), then the other subscribers are called once per event, in order, from the same
+ * task.
+ *
+ * @tparam EventSignature The event signature of the events to publish.
+ * @tparam Network The network type (default is `internal::Default`).
+ * @tparam Range A range of `event_t<EventSignature>`, e.g. a `std::span` or a `std::vector`.
+ * @param events The events to publish.
+ *
+ * Example
+ * @code
+ * std::vector<dispatcher::event_t<MyEvent>> events{{1, "one"}, {2, "two"}};
+ * dispatcher::publish_batch<MyEvent>(events);
+ * @endcode
+ */
+template <typename EventSignature, typename Network = internal::Default, typename Range>
+void publish_batch(Range &&events)
+{
+    internal::EventDispatcher<EventSignature, Network>::publish_batch(std::forward<Range>(events));
+}
+
+/**
+ * @brief Get the counters of the bounded event queue of an event signature.
+ *
+ * @tparam EventSignature The event signature, or its network, must declare an `event_queue_bound`.
+ * @tparam Network The network type (default is `internal::Default`).
+ * @return The current and largest depths of the queue, the number of dropped and rejected events, and of the
+ * publishers blocked. Empty if the queue is not bounded.
+ *
+ * Example
+ * @code
+ * struct Telemetry {
+ *     using parameters_t = std::tuple<std::string>;
+ *     static constexpr std::size_t event_queue_bound = 256;
+ *     static constexpr dispatcher::OverflowPolicy overflow_policy = dispatcher::OverflowPolicy::DropOldest;
+ * };
+ *
+ * auto stats = dispatcher::get_event_queue_stats<Telemetry>();
+ * std::cout << stats.dropped << " events dropped, up to " << stats.high_water_depth << " queued" << std::endl;
+ * @endcode
+ */
+template <typename EventSignature, typename Network = internal::Default>
+EventQueueStats get_event_queue_stats()
+{
+    return internal::EventDispatcher<EventSignature, Network>::get_queue_stats();
+}
+
+/**
+ * @brief Read the value published last of a conflating event, without waiting for the event loop.
+ *
+ * The value is updated as soon as it is published, possibly before the subscribers receive it. Reading never blocks the
+ * publishers of values whose parameters are all trivially copyable, it only retries while one overwrites the value.
+ * At most one value waits for the event loop, the depths reported by `get_event_queue_stats` are therefore 0 or 1, and
+ * the overwritten values are counted as dropped.
+ *
+ * @tparam EventSignature The event signature, which must declare `conflate = true`.
+ * @tparam Network The network type (default is `internal::Default`).
+ * @return The value published last, as an `event_t<EventSignature>`, or an empty optional if none was published yet.
+ *
+ * Example
+ * @code
+ * struct VehicleSpeed {
+ *     using parameters_t = std::tuple<float>;
+ *     static constexpr bool conflate = true;
+ * };
+ *
+ * dispatcher::publish<VehicleSpeed>(13.9f);
+ * float speed = dispatcher::get_latest<VehicleSpeed>().value_or(0.0f);
+ * @endcode
+ */
+template <typename EventSignature, typename Network = internal::Default>
+std::optional<event_t<EventSignature, Network>> get_latest()
+{
+    return internal::EventDispatcher<EventSignature, Network>::get_latest();
+}
+
 /**
  * @brief Post a task to the event loop for asynchronous execution.
  *
@@ -710,11 +5612,124 @@ void post(T &&task)
     internal::getEventLoop<Network>().Post(std::forward<T>(task));
 }
 
+/**
+ * @brief Post a task to a priority lane of the event loop.
+ *
+ * Pending tasks, events and asynchronous calls of a higher priority are started first, so that a burst of low-priority
+ * work does not delay the latency-sensitive one. Fibers resumed after suspending are also scheduled by the priority of
+ * their task. Event and function signatures, and the subscribers of an event, get their priority from a `priority`
+ * declared in the signature, `Priority::Normal` by default.
+ *
+ * A lower priority lane with pending work is still served after being passed over `priority_starvation_limit` times in
+ * a row (16 by default, 0 serves the lanes strictly by priority). Tasks marked as non-suspending run inline in the
+ * order they are posted. Networks declaring an ingress queue get one per priority.
+ *
+ * @tparam priority The priority of the task.
+ * @tparam Network The network type (default is `internal::Default`).
+ * @tparam T The type of the task.
+ * @param task The task to execute asynchronously.
+ *
+ * Example:
+ * @code
+ * struct VehicleNetwork {
+ *     static constexpr std::size_t priority_starvation_limit = 8;
+ * };
+ *
+ * struct EmergencyBrake {
+ *     using args_t = std::tuple<>;
+ *     using return_t = void;
+ *     static constexpr dispatcher::Priority priority = dispatcher::Priority::High;
+ * };
+ *
+ * dispatcher::post<dispatcher::Priority::Low, VehicleNetwork>([] { uploadTelemetry(); });
+ * dispatcher::async_call<EmergencyBrake, VehicleNetwork>();  // Started before the pending telemetry uploads
+ * @endcode
+ */
+template <Priority priority, typename Network = internal::Default, typename T>
+void post(T &&task)
+{
+    internal::getEventLoop<Network>().template Post<internal::Execution::Fiber, 0, priority>(std::forward<T>(task));
+}
+
+/**
+ * @brief Post a non-suspending task to the event loop.
+ *
+ * The task is executed directly on the event loop thread driving the io_context, without creating a fiber for it.
+ * This removes the cost of the fiber creation and of the context switches, but the task must not block: waiting on a
+ * future, a fiber mutex or a condition variable, sleeping or yielding would stall the whole event loop. In debug
+ * builds, a non-suspending task trying to block triggers an assertion.
+ *
+ * The same behavior can be selected for every task of a network, or for every publish of an event and every
+ * `async_call` of a function, by declaring `static constexpr bool non_suspending = true;` in the network, event
+ * signature or function signature.
+ *
+ * @tparam Network The network type (default is `internal::Default`).
+ * @tparam T The type of the task.
+ * @param task The task to execute asynchronously.
+ *
+ * Example:
+ * @code
+ * dispatcher::post_inline([] {
+ *     std::cout << "Task executed on the event loop thread!" << std::endl;
+ * });
+ *
+ * struct SpeedChanged {
+ *     using parameters_t = std::tuple<float>;
+ *     static constexpr bool non_suspending = true;
+ * };
+ * @endcode
+ */
+template <typename Network = internal::Default, typename T>
+void post_inline(T &&task)
+{
+    internal::getEventLoop<Network>().template Post<internal::Execution::Inline>(std::forward<T>(task));
+}
+
+/**
+ * @brief Post a task to the ingress queue of the event loop without blocking nor allocating.
+ *
+ * The network must declare the capacity of its ingress queue, which has to be a power of two. The task is stored in
+ * place in a pre-allocated slot of `ingress_task_size` bytes (64 by default), a task that does not fit does not
+ * compile. This makes `try_post` usable from real-time threads. Networks declaring an ingress queue also use it for
+ * `post` and `publish`, which never fail: the tasks finding the queue full are kept in order in a list behind it, which
+ * locks and allocates. Only `try_post` and `try_publish` are therefore real-time safe. `try_post` also fails until
+ * the tasks of that list are drained, so that the tasks of a thread are always started in the order they were posted.
+ * The tasks, and the events published, must fit in the slots for `post` and `publish` as well.
+ *
+ * @tparam Network The network type, which must declare `ingress_queue_capacity`.
+ * @tparam T The type of the task.
+ * @param task The task to execute asynchronously. It is left untouched if the queue is full.
+ * @return `PostStatus::Posted` if the task was queued, `PostStatus::QueueFull` otherwise.
+ *
+ * Example:
+ * @code
+ * struct SensorNetwork {
+ *     static constexpr std::size_t ingress_queue_capacity = 1024;
+ *     static constexpr std::size_t ingress_task_size = 128; // Optional
+ * };
+ *
+ * if (dispatcher::try_post<SensorNetwork>([] { std::cout << "Task executed asynchronously!" << std::endl; }) !=
+ *     dispatcher::PostStatus::Posted) {
+ *     // Handle the overload
+ * }
+ * @endcode
+ */
+template <typename Network, typename T>
+PostStatus try_post(T &&task)
+{
+    return internal::getEventLoop<Network>().TryPost(std::forward<T>(task));
+}
+
 /**
  * @brief Set the number of worker threads for the event loop.
  *
  * This function configures the number of worker threads in the event loop associated with the specified network.
  * Worker threads are used to process tasks asynchronously. By default, the event loop runs with a single thread.
+ * The worker threads share a single fiber ready queue, so posted tasks, events and asynchronous calls are spread
+ * across all of them, and fibers can migrate between them. Every worker thread runs the io_context of the network,
+ * one at a time: the thread leading it hands it over to a sleeping worker thread whenever it has fibers to run. A task
+ * blocking its thread without suspending its fiber therefore only delays the timers, non-suspending tasks and wake-ups
+ * of the network when no other worker thread is sleeping.
  *
  * @tparam Network The network type (default is `internal::Default`).
  * @param thread_count The number of worker threads to set for the event loop.
@@ -734,6 +5749,116 @@ void set_worker_threads(int thread_count)
     internal::getEventLoop<Network>().SetWorkerThreadsAmount(thread_count);
 }
 
+/**
+ * @brief Get the statistics of the fiber stack cache of a network.
+ *
+ * Fiber stacks are cached per network. Every worker thread keeps a small magazine of free stacks, and exchanges them
+ * with a depot shared by the worker threads of the network. The depot is filled with `stack_cache_low_watermark`
+ * stacks (8 by default) when the network starts, and releases stacks back to the system when it holds more than
+ * `stack_cache_high_watermark` of them (128 by default), until it is back to the low watermark.
+ *
+ * The fibers of a network use stacks of `stack_size` bytes (30000 by default, rounded up to whole pages), each with a
+ * guard page below it so that an overflow crashes right away. A FuncSignature or EventSignature can declare its own
+ * `stack_size`, its handlers then run on fibers with stacks of that size. These are kept in a separate cache, without
+ * per-thread magazines nor pre-allocation, and are counted in these statistics as well.
+ *
+ * A network declaring a `stack_arena_size` reserves a region of that size up front, backed by huge pages when possible,
+ * and carves the stacks of its size out of it. This reduces the TLB misses when many fibers are alive. Stacks of the
+ * arena have no guard page, and stacks are mapped individually again once the arena is exhausted.
+ *
+ * @tparam Network The network type (default is `internal::Default`).
+ * @return The hits, misses, the amount of stacks and bytes currently held by the cache, and the size of the arena.
+ *
+ * Example:
+ * @code
+ * struct WorkNetwork {
+ *     static constexpr std::size_t stack_size = 16 * 1024;
+ *     static constexpr std::size_t stack_cache_low_watermark = 32;
+ *     static constexpr std::size_t stack_cache_high_watermark = 512;
+ *     static constexpr std::size_t stack_arena_size = 64 * 1024 * 1024;
+ * };
+ *
+ * auto stats = dispatcher::get_stack_cache_stats<WorkNetwork>();
+ * std::cout << stats.blocks_held << " stacks cached, " << stats.misses << " allocated" << std::endl;
+ * @endcode
+ */
+template <typename Network = internal::Default>
+StackCacheStats get_stack_cache_stats()
+{
+    return internal::getEventLoop<Network>().GetStackCacheStats();
+}
+
+/**
+ * @brief Get the stack usage of the fibers of a network.
+ *
+ * A network declaring `profile_stack_usage` paints the stacks of its fibers with a pattern when they are allocated, and
+ * measures how much of them was overwritten when they are released. The high-water marks are aggregated for the whole
+ * network and, for events and asynchronous calls, per EventSignature or FuncSignature: the fibers of the network run a
+ * single task each, which is accounted for once its fiber released its stack, shortly after the task returned. This
+ * makes every task more expensive, and is meant to size the `stack_size` of networks and signatures.
+ *
+ * @tparam Network The network type (default is `internal::Default`).
+ * @return The stack usage of the network and of its signatures, empty if the network does not profile it.
+ *
+ * Example:
+ * @code
+ * struct WorkNetwork {
+ *     static constexpr bool profile_stack_usage = true;
+ * };
+ *
+ * auto profile = dispatcher::get_stack_profile<WorkNetwork>();
+ * for (const auto &[signature, usage] : profile.signatures) {
+ *     std::cout << signature << " used " << usage.high_water_mark << " of " << usage.stack_size << " bytes"
+ *               << std::endl;
+ * }
+ * @endcode
+ */
+template <typename Network = internal::Default>
+StackProfile get_stack_profile()
+{
+    return internal::getEventLoop<Network>().GetStackProfile();
+}
+
+/**
+ * @brief Get the queue latencies of the tasks of a network, per priority.
+ *
+ * A network declaring `measure_queue_latency` timestamps every task, event and asynchronous call when it is posted,
+ * and measures how long it waited before starting to run. This adds two clock reads per task.
+ *
+ * @tparam Network The network type (default is `internal::Default`).
+ * @return The number of measured tasks, and the sum and maximum of their queue latencies, per Priority. Empty if the
+ * network does not measure them.
+ *
+ * Example:
+ * @code
+ * struct VehicleNetwork {
+ *     static constexpr bool measure_queue_latency = true;
+ * };
+ *
+ * auto stats = dispatcher::get_queue_latency_stats<VehicleNetwork>();
+ * std::cout << "High priority tasks waited " << stats[dispatcher::Priority::High].mean().count() << " ns on average"
+ *           << std::endl;
+ * @endcode
+ */
+template <typename Network = internal::Default>
+QueueLatencyStats get_queue_latency_stats()
+{
+    return internal::getEventLoop<Network>().GetQueueLatencyStats();
+}
+
+/**
+ * @brief Get the number of asynchronous calls of a network dropped because their deadline passed or they were
+ * cancelled before running.
+ *
+ * @tparam Network The network type (default is `internal::Default`).
+ * @return The number of dropped calls, per reason.
+ */
+template <typename Network = internal::Default>
+DroppedCallStats get_dropped_call_stats()
+{
+    return internal::getEventLoop<Network>().GetDroppedCallStats();
+}
+
 /**
  * @brief A timer utility for scheduling tasks in the event loop.
  *
@@ -741,6 +5866,10 @@ void set_worker_threads(int thread_count)
  * or repeatedly at regular intervals. It uses the event loop associated with the specified network
  * to handle the execution of tasks asynchronously.
  *
+ * The timers of a network are kept in a hierarchical timing wheel driven by a single asio timer, so that scheduling
+ * and cancelling a timer takes constant time however many are armed, and the timers expiring together are dispatched
+ * in one go. Durations are rounded to the resolution of the wheel, 1 ms unless the network declares a `timer_tick_ms`.
+ *
  * @tparam Network The network type (default is `internal::Default`).
  */
 template <typename Network>
@@ -751,8 +5880,34 @@ class Timer {
      *
      * Initializes the timer using the IO context of the event loop associated with the specified network.
      */
-    Timer() : timer_(internal::getEventLoop<Network>().GetIOContext())
+    Timer() : wheel_(internal::getEventLoop<Network>().GetTimerWheel())
+    {
+    }
+    ~Timer()
+    {
+        Cancel();
+    }
+
+    Timer(const Timer &) = delete;
+    Timer &operator=(const Timer &) = delete;
+
+    /**
+     * @brief Move a Timer, the task it scheduled being handed over to the new Timer.
+     */
+    Timer(Timer &&other) : wheel_(other.wheel_)
+    {
+        wheel_.Move(other.entry_, entry_);
+    }
+
+    /**
+     * @brief Move a Timer, the task it scheduled replacing the one of this Timer, which is cancelled.
+     */
+    Timer &operator=(Timer &&other)
     {
+        if (this != &other) {
+            wheel_.Move(other.entry_, entry_);
+        }
+        return *this;
     }
 
     /**
@@ -763,7 +5918,7 @@ class Timer {
      */
     void Cancel()
     {
-        timer_.cancel();
+        wheel_.Cancel(entry_);
     }
 
     /**
@@ -787,19 +5942,60 @@ class Timer {
     template <typename Duration, typename Callback>
     void DoIn(Duration duration, Callback &&callback)
     {
-        timer_.expires_from_now(
-            boost::posix_time::milliseconds(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()));
-        timer_.async_wait([callback = std::forward<Callback>(callback)](const boost::system::error_code &ec) mutable {
-            if (ec != boost::asio::error::operation_aborted) {
-                internal::getEventLoop<Network>().Post(std::forward<Callback>(callback));
-            }
-        });
+        wheel_.Schedule(entry_,
+                        std::chrono::duration_cast<std::chrono::milliseconds>(duration),
+                        std::chrono::milliseconds{0},
+                        [callback = std::forward<Callback>(callback)](bool expired) mutable {
+                            if (expired) {
+                                internal::getEventLoop<Network>().Post(std::move(callback));
+                            }
+                        });
+    }
+
+    /**
+     * @brief Get a future fulfilled after a specified duration, e.g. to be awaited by a Coroutine.
+     *
+     * Like DoIn, it replaces the task or future already scheduled by this timer. The future holds a
+     * `boost::system::system_error` if the timer is cancelled first.
+     *
+     * @tparam Duration The type of the duration (e.g., `std::chrono::milliseconds`).
+     * @param duration The duration to wait before fulfilling the future.
+     * @return A Future fulfilled once the duration elapsed.
+     *
+     * Example:
+     * @code
+     * dispatcher::Timer<> timer;
+     * co_await timer.After(std::chrono::seconds(5));
+     * @endcode
+     */
+    template <typename Duration>
+    Future<void> After(Duration duration)
+    {
+        boost::fibers::promise<void> promise;
+        auto slot = std::make_shared<internal::ContinuationSlot>();
+        Future<void> future{promise.get_future(), slot};
+        wheel_.Schedule(entry_,
+                        std::chrono::duration_cast<std::chrono::milliseconds>(duration),
+                        std::chrono::milliseconds{0},
+                        [promise = std::move(promise), slot = std::move(slot)](bool expired) mutable {
+                            if (expired) {
+                                promise.set_value();
+                            } else {
+                                promise.set_exception(std::make_exception_ptr(
+                                    boost::system::system_error{boost::asio::error::operation_aborted}));
+                            }
+                            slot->Ready();
+                        });
+        return future;
     }
 
     /**
      * @brief Schedule a task to be executed repeatedly at regular intervals.
      *
-     * This function schedules a task to be executed repeatedly at the specified interval.
+     * This function schedules a task to be executed repeatedly at the specified interval. The intervals are counted
+     * from the first expiry, not from the execution of the callback. The callback is shared by all the executions,
+     * which never overlap: an interval elapsing while the previous execution is still running is executed right
+     * after it. Intervals shorter than the resolution of the timers are rounded up to it.
      *
      * @tparam Duration The type of the duration (e.g., `std::chrono::milliseconds`).
      * @tparam Callback The type of the callback function.
@@ -817,19 +6013,23 @@ class Timer {
     template <typename Duration, typename Callback>
     void DoEvery(Duration duration, Callback &&callback)
     {
-        timer_.expires_from_now(
-            boost::posix_time::milliseconds(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()));
-        timer_.async_wait(
-            [this, callback = std::forward<Callback>(callback), duration](const boost::system::error_code &ec) mutable {
-                if (ec != boost::asio::error::operation_aborted) {
-                    internal::getEventLoop<Network>().Post(callback);
-                    DoEvery(duration, std::forward<Callback>(callback));
-                }
-            });
+        auto periodic = std::make_shared<internal::PeriodicCallback<std::decay_t<Callback>>>(
+            std::decay_t<Callback>{std::forward<Callback>(callback)});
+        auto interval = std::max(std::chrono::ceil<std::chrono::milliseconds>(duration), std::chrono::milliseconds{1});
+        wheel_.Schedule(entry_, interval, interval, [periodic = std::move(periodic)](bool expired) {
+            if (expired && periodic->pending.fetch_add(1) == 0) {
+                internal::getEventLoop<Network>().Post([periodic] {
+                    do {
+                        periodic->callback();
+                    } while (periodic->pending.fetch_sub(1) > 1);
+                });
+            }
+        });
     }
 
   private:
-    boost::asio::basic_deadline_timer<boost::posix_time::ptime, internal::MockableClock> timer_;
+    internal::TimerWheel<Network> &wheel_;
+    typename internal::TimerWheel<Network>::Entry entry_;
 };
 
 using DefaultTimer = Timer<internal::Default>;
@@ -408,7 +408,7 @@ class EventExpecter : public ExpecterBase {
     template <typename... Parameters>
     void subscribe()
     {
-        dispatcher::subscribe<EventSignature>([this](Parameters &&...parameters) {
+        dispatcher::subscribe<EventSignature>([this](subscriber_parameter_t<Parameters> &&...parameters) {
             for (const auto &should_not_be_published : should_not_be_published_) {
                 if (call_tuple(std::get<2>(should_not_be_published),
                                std::make_index_sequence<EventExpectation<EventSignature>::tuple_size>{},
@@ -420,7 +420,7 @@ class EventExpecter : public ExpecterBase {
 
             for (auto &expectation : remaining_expectation_) {
                 if (expectation.validate(parameters...)) {
-                    expectation.on_event(std::forward<Parameters>(parameters)...);
+                    expectation.on_event(std::forward<subscriber_parameter_t<Parameters>>(parameters)...);
                     break;
                 }
             }
@@ -16,6 +16,14 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <thread>
 #include <tuple>
@@ -38,7 +46,42 @@ struct AnotherEvent {
     using parameters_t = std::tuple<>;
 };
 
-class ExampleTest : public dispatcher::Test {};
+class ExampleTest : public dispatcher::Test {
+  protected:
+    // Blocks the event loop of Network with a non-suspending task, so that the tasks posted until ReleaseEventLoop is
+    // called stay queued. Returns once the event loop is blocked, a single one can be blocked per test.
+    template <typename Network>
+    void BlockEventLoop()
+    {
+        std::promise<void> blocked;
+        auto blocked_future = blocked.get_future();
+        dispatcher::post_inline<Network>(
+            [blocked = std::move(blocked), released = release_.get_future().share()]() mutable {
+                blocked.set_value();
+                released.wait();
+            });
+        blocked_future.wait();
+    }
+
+    void ReleaseEventLoop()
+    {
+        if (!released_) {
+            released_ = true;
+            release_.set_value();
+        }
+    }
+
+    // A failed assertion must not leave the event loop blocked
+    void TearDown() override
+    {
+        ReleaseEventLoop();
+        dispatcher::Test::TearDown();
+    }
+
+  private:
+    std::promise<void> release_;
+    bool released_ = false;
+};
 
 TEST_F(ExampleTest, ExpectingEventUnordered)
 {
@@ -154,3 +197,1063 @@ TEST_F(ExampleTest, OnCallWithReferences)
     dispatcher::call<CallWithReferences>(a_string);
     dispatcher::call<CallWithReferences>(a_string);
 }
+
+struct StaticAddition {
+    using args_t = std::tuple<int, int>;
+    using return_t = int;
+};
+
+int Add(int a, int b)
+{
+    return a + b;
+}
+
+DISPATCHER_ATTACH_STATIC(StaticAddition, &Add);
+
+// The event loop of the default network is stopped by the fixture after each test
+struct CallNetwork {};
+
+TEST_F(ExampleTest, CallStaticHandler)
+{
+    EXPECT_EQ(dispatcher::call<StaticAddition>(2, 3), 5);
+    EXPECT_EQ((dispatcher::async_call<StaticAddition, CallNetwork>(4, 3).get()), 7);
+}
+
+struct MoveOnlyHandler {
+    using args_t = std::tuple<int>;
+    using return_t = int;
+};
+
+TEST_F(ExampleTest, AttachMoveOnlyHandler)
+{
+    auto offset = std::make_unique<int>(40);
+    dispatcher::attach<MoveOnlyHandler>([offset = std::move(offset)](int value) { return *offset + value; });
+    EXPECT_EQ(dispatcher::call<MoveOnlyHandler>(2), 42);
+    EXPECT_EQ((dispatcher::async_call<MoveOnlyHandler, CallNetwork>(2).get()), 42);
+    dispatcher::detach<MoveOnlyHandler>();
+    EXPECT_THROW(dispatcher::call<MoveOnlyHandler>(2), dispatcher::NoHandler<MoveOnlyHandler>);
+}
+
+struct HotSwap {
+    using args_t = std::tuple<>;
+    using return_t = int;
+};
+
+TEST_F(ExampleTest, ReattachWhileCallInFlight)
+{
+    std::atomic<int> destroyed{0};
+    boost::fibers::promise<void> release;
+    auto released = release.get_future().share();
+    std::shared_ptr<void> first_token{nullptr, [&destroyed](void *) { ++destroyed; }};
+    dispatcher::attach<HotSwap>([token = std::move(first_token), released] {
+        released.wait();
+        return token ? 0 : 1;
+    });
+    std::atomic<bool> started{false};
+    std::thread caller{[&started] {
+        started = true;
+        EXPECT_EQ(dispatcher::call<HotSwap>(), 1);
+    }};
+    while (!started) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    dispatcher::attach<HotSwap>([] { return 2; });
+    EXPECT_EQ(dispatcher::call<HotSwap>(), 2);
+    dispatcher::attach<HotSwap>([] { return 3; });
+    EXPECT_EQ(destroyed, 0);
+
+    release.set_value();
+    caller.join();
+    dispatcher::detach<HotSwap>();
+    EXPECT_EQ(destroyed, 1);
+    EXPECT_THROW(dispatcher::call<HotSwap>(), dispatcher::NoHandler<HotSwap>);
+}
+
+struct SelfDetaching {
+    using args_t = std::tuple<>;
+    using return_t = void;
+};
+
+TEST_F(ExampleTest, DetachedHandlerIsReclaimedOnceItsCallsReturn)
+{
+    auto capture = std::make_shared<int>(0);
+    std::weak_ptr<int> captured = capture;
+    dispatcher::attach<SelfDetaching>([capture = std::move(capture)] { dispatcher::detach<SelfDetaching>(); });
+    // Retired while the call is still using it, destroyed from the reclaiming event loop once the call returned, no
+    // later attach or detach is needed
+    dispatcher::call<SelfDetaching>();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    while (!captured.expired() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    EXPECT_TRUE(captured.expired());
+    EXPECT_THROW(dispatcher::call<SelfDetaching>(), dispatcher::NoHandler<SelfDetaching>);
+}
+
+TEST_F(ExampleTest, ReattachUnderConcurrentCalls)
+{
+    dispatcher::attach<HotSwap>([] { return 0; });
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> callers;
+    for (int i = 0; i < 4; ++i) {
+        callers.emplace_back([&stop] {
+            while (!stop) {
+                auto value = dispatcher::call<HotSwap>();
+                EXPECT_GE(value, 0);
+                EXPECT_LT(value, 1000);
+            }
+        });
+    }
+    for (int i = 0; i < 1000; ++i) {
+        auto value = std::make_shared<int>(i);
+        dispatcher::attach<HotSwap>([value] { return *value; });
+    }
+    stop = true;
+    for (auto &caller : callers) {
+        caller.join();
+    }
+    dispatcher::detach<HotSwap>();
+}
+
+struct MaybeAttached {
+    using args_t = std::tuple<int>;
+    using return_t = int;
+};
+
+struct MaybeAttachedVoid {
+    using args_t = std::tuple<>;
+};
+
+TEST_F(ExampleTest, TryCallReportsMissingHandler)
+{
+    auto missing = dispatcher::try_call<MaybeAttached>(1);
+    ASSERT_FALSE(missing);
+    EXPECT_EQ(missing.error(), dispatcher::CallError::NoHandler);
+    EXPECT_THROW(missing.value(), dispatcher::BadCallResultAccess);
+    EXPECT_EQ((dispatcher::try_async_call<MaybeAttached, CallNetwork>(1).get().error()),
+              dispatcher::CallError::NoHandler);
+    EXPECT_FALSE(dispatcher::try_call<MaybeAttachedVoid>());
+
+    dispatcher::attach<MaybeAttached>([](int value) { return value + 1; });
+    dispatcher::attach<MaybeAttachedVoid>([] {});
+    EXPECT_EQ(dispatcher::try_call<MaybeAttached>(1).value(), 2);
+    EXPECT_EQ((*dispatcher::try_async_call<MaybeAttached, CallNetwork>(2).get()), 3);
+    EXPECT_TRUE(dispatcher::try_call<MaybeAttachedVoid>());
+    dispatcher::detach<MaybeAttached>();
+    dispatcher::detach<MaybeAttachedVoid>();
+}
+
+TEST_F(ExampleTest, AsyncCallPropagatesExceptions)
+{
+    EXPECT_THROW((dispatcher::async_call<MaybeAttached, CallNetwork>(1).get()), dispatcher::NoHandler<MaybeAttached>);
+
+    dispatcher::attach<MaybeAttached>([](int) -> int { throw std::runtime_error{"failed"}; });
+    EXPECT_THROW((dispatcher::async_call<MaybeAttached, CallNetwork>(1).get()), std::runtime_error);
+    EXPECT_THROW((dispatcher::try_async_call<MaybeAttached, CallNetwork>(1).get()), std::runtime_error);
+    dispatcher::detach<MaybeAttached>();
+}
+
+TEST_F(ExampleTest, AsyncCallBatch)
+{
+    dispatcher::attach<MaybeAttached>([](int value) { return value * 2; });
+    std::vector<std::tuple<int>> batch{{1}, {2}, {3}};
+    EXPECT_EQ((dispatcher::async_call_batch<MaybeAttached, CallNetwork>(batch).get()), (std::vector<int>{2, 4, 6}));
+    EXPECT_TRUE(
+        (dispatcher::async_call_batch<MaybeAttached, CallNetwork>(std::vector<std::tuple<int>>{}).get().empty()));
+    dispatcher::detach<MaybeAttached>();
+    EXPECT_THROW((dispatcher::async_call_batch<MaybeAttached, CallNetwork>(batch).get()),
+                 dispatcher::NoHandler<MaybeAttached>);
+
+    int calls = 0;
+    dispatcher::attach<MaybeAttachedVoid>([&calls] { ++calls; });
+    dispatcher::async_call_batch<MaybeAttachedVoid, CallNetwork>(std::vector<std::tuple<>>(5)).get();
+    EXPECT_EQ(calls, 5);
+    dispatcher::detach<MaybeAttachedVoid>();
+}
+
+struct EventNetwork {};
+
+struct BatchedEvent {
+    using parameters_t = std::tuple<int, const std::string &>;
+};
+
+struct ColumnarEvent {
+    using parameters_t = std::tuple<int, float>;
+    static constexpr bool columnar_batch = true;
+};
+
+TEST_F(ExampleTest, PublishBatch)
+{
+    std::vector<int> received;
+    std::vector<std::size_t> batch_sizes;
+    boost::fibers::promise<void> done;
+    auto connection = dispatcher::subscribe<BatchedEvent, EventNetwork>([&](int id, const std::string &) {
+        received.push_back(id);
+        if (id == 4) {
+            done.set_value();
+        }
+    });
+    auto batch_connection = dispatcher::subscribe_batch<BatchedEvent, EventNetwork>(
+        [&](std::span<const dispatcher::event_t<BatchedEvent>> events) { batch_sizes.push_back(events.size()); });
+
+    std::vector<dispatcher::event_t<BatchedEvent>> events{{1, "one"}, {2, "two"}, {3, "three"}};
+    dispatcher::publish_batch<BatchedEvent, EventNetwork>(std::span{events});
+    dispatcher::publish<BatchedEvent, EventNetwork>(4, "four");
+    done.get_future().wait();
+
+    EXPECT_EQ(received, (std::vector<int>{1, 2, 3, 4}));
+    EXPECT_EQ(batch_sizes, (std::vector<std::size_t>{3, 1}));
+    connection.disconnect();
+    batch_connection.disconnect();
+}
+
+TEST_F(ExampleTest, PublishColumnarBatch)
+{
+    float total = 0;
+    int calls = 0;
+    boost::fibers::promise<void> done;
+    auto connection = dispatcher::subscribe<ColumnarEvent, EventNetwork>([&](int, float) {
+        if (++calls == 2) {
+            done.set_value();
+        }
+    });
+    auto batch_connection = dispatcher::subscribe_batch<ColumnarEvent, EventNetwork>(
+        [&](std::span<const int> ids, std::span<const float> values) {
+            EXPECT_EQ(ids.size(), values.size());
+            for (auto value : values) {
+                total += value;
+            }
+        });
+
+    dispatcher::publish_batch<ColumnarEvent, EventNetwork>(std::vector<std::tuple<int, float>>{{1, 0.5f}, {2, 1.5f}});
+    done.get_future().wait();
+
+    EXPECT_EQ(total, 2.0f);
+    EXPECT_EQ(calls, 2);
+    connection.disconnect();
+    batch_connection.disconnect();
+}
+
+TEST(SubscriberListTest, DisconnectDuringEmission)
+{
+    dispatcher::internal::SubscriberList<void(int)> subscribers;
+    dispatcher::Connection second;
+    int first_calls = 0;
+    int second_calls = 0;
+    auto first = subscribers.Connect([&](int) {
+        ++first_calls;
+        second.disconnect();
+    });
+    second = subscribers.Connect([&second_calls, owned = std::make_unique<int>(1)](int value) {
+        second_calls += value * *owned;
+    });
+    EXPECT_TRUE(second.connected());
+
+    subscribers(1);
+    EXPECT_EQ(first_calls, 1);
+    EXPECT_EQ(second_calls, 0);
+    EXPECT_FALSE(second.connected());
+
+    first.disconnect();
+    EXPECT_TRUE(subscribers.Empty());
+    subscribers(1);
+    EXPECT_EQ(first_calls, 1);
+}
+
+struct Frame {
+    Frame() = default;
+    Frame(const Frame &other) : pixels(other.pixels) { ++copies; }
+    Frame(Frame &&) = default;
+
+    std::vector<int> pixels = std::vector<int>(1024, 7);
+    static inline int copies = 0;
+};
+
+struct FrameReceived {
+    using parameters_t = std::tuple<dispatcher::Shared<Frame>>;
+    static constexpr bool zero_copy = true;
+};
+
+TEST_F(ExampleTest, SharedPayloadIsNotCopied)
+{
+    std::vector<const Frame *> received;
+    boost::fibers::promise<void> done;
+    auto first =
+        dispatcher::subscribe<FrameReceived, EventNetwork>([&](const Frame &frame) { received.push_back(&frame); });
+    auto second = dispatcher::subscribe<FrameReceived, EventNetwork>(
+        [&](const dispatcher::Shared<Frame> &frame) { received.push_back(&frame.get()); });
+    auto third = dispatcher::subscribe<FrameReceived, EventNetwork>([&](const Frame &frame) {
+        received.push_back(&frame);
+        done.set_value();
+    });
+
+    Frame::copies = 0;
+    dispatcher::publish<FrameReceived, EventNetwork>(Frame{});
+    done.get_future().wait();
+
+    EXPECT_EQ(Frame::copies, 0);
+    ASSERT_EQ(received.size(), 3u);
+    EXPECT_EQ(received[0], received[1]);
+    EXPECT_EQ(received[1], received[2]);
+    first.disconnect();
+    second.disconnect();
+    third.disconnect();
+}
+
+struct VehicleSignal {
+    using key_t = int;
+    using parameters_t = std::tuple<double>;
+};
+
+TEST_F(ExampleTest, KeyedEventsReachTheirKeyOnly)
+{
+    std::vector<double> speeds;
+    std::vector<double> temperatures;
+    std::vector<double> all;
+    boost::fibers::promise<void> done;
+    auto speed = dispatcher::subscribe<VehicleSignal, EventNetwork>(1, [&](double value) { speeds.push_back(value); });
+    auto temperature =
+        dispatcher::subscribe<VehicleSignal, EventNetwork>(2, [&](double value) { temperatures.push_back(value); });
+    auto every = dispatcher::subscribe<VehicleSignal, EventNetwork>([&](double value) {
+        all.push_back(value);
+        if (all.size() == 3) {
+            done.set_value();
+        }
+    });
+
+    dispatcher::publish<VehicleSignal, EventNetwork>(1, 50.0);
+    dispatcher::publish<VehicleSignal, EventNetwork>(2, 20.0);
+    dispatcher::publish<VehicleSignal, EventNetwork>(3, 0.0);
+    done.get_future().wait();
+
+    EXPECT_EQ(speeds, std::vector<double>{50.0});
+    EXPECT_EQ(temperatures, std::vector<double>{20.0});
+    EXPECT_EQ(all, (std::vector<double>{50.0, 20.0, 0.0}));
+    speed.disconnect();
+    temperature.disconnect();
+    every.disconnect();
+}
+
+TEST(InplaceFunctionTest, StoresLargeCallablesOnHeap)
+{
+    std::array<int, 64> values{};
+    values.back() = 42;
+    dispatcher::internal::InplaceFunction<int(), 16> function{[values] { return values.back(); }};
+    auto moved = std::move(function);
+    EXPECT_FALSE(function);
+    EXPECT_EQ(moved(), 42);
+    EXPECT_THROW(function(), std::bad_function_call);
+}
+
+struct WorkerPoolNetwork {};
+
+TEST_F(ExampleTest, WorkerThreadsRunTasksInParallel)
+{
+    dispatcher::set_worker_threads<WorkerPoolNetwork>(4);
+    EXPECT_EQ(dispatcher::internal::getEventLoop<WorkerPoolNetwork>().GetWorkerThreadsAmount(), 4);
+
+    // Each task blocks its thread until another task is running, which can only happen on another worker thread
+    std::atomic<int> running{0};
+    std::atomic<bool> ran_in_parallel{false};
+    std::vector<std::promise<void>> done(2);
+    for (auto &promise : done) {
+        dispatcher::post<WorkerPoolNetwork>([&] {
+            running++;
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+            while (running < 2 && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+            if (running >= 2) {
+                ran_in_parallel = true;
+            }
+            promise.set_value();
+        });
+    }
+    for (auto &promise : done) {
+        promise.get_future().wait();
+    }
+    EXPECT_TRUE(ran_in_parallel);
+}
+
+struct HandOverNetwork {};
+
+TEST_F(ExampleTest, BlockedWorkerThreadHandsTheIOContextOver)
+{
+    dispatcher::set_worker_threads<HandOverNetwork>(2);
+
+    // Whichever thread was running the io_context, the other one takes it over while this task blocks its thread
+    std::promise<void> inline_ran;
+    std::promise<bool> done;
+    dispatcher::post<HandOverNetwork>([&] {
+        dispatcher::post_inline<HandOverNetwork>([&] { inline_ran.set_value(); });
+        done.set_value(inline_ran.get_future().wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    });
+    EXPECT_TRUE(done.get_future().get());
+}
+
+struct IngressNetwork {
+    static constexpr std::size_t ingress_queue_capacity = 4;
+};
+
+TEST_F(ExampleTest, IngressQueueReportsWhenFull)
+{
+    // Keep the event loop busy so that the ingress queue is not drained
+    std::promise<void> started;
+    std::promise<void> release;
+    auto release_future = release.get_future().share();
+    auto status = dispatcher::try_post<IngressNetwork>([&started, release_future] {
+        started.set_value();
+        release_future.wait();
+    });
+    EXPECT_EQ(status, dispatcher::PostStatus::Posted);
+    started.get_future().wait();
+
+    std::atomic<int> executed{0};
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(dispatcher::try_post<IngressNetwork>([&executed] { executed++; }), dispatcher::PostStatus::Posted);
+    }
+    EXPECT_EQ(dispatcher::try_post<IngressNetwork>([&executed] { executed++; }), dispatcher::PostStatus::QueueFull);
+
+    std::promise<void> published;
+    auto connection = dispatcher::subscribe<AnotherEvent, IngressNetwork>([&published] { published.set_value(); });
+    status = dispatcher::try_publish<AnotherEvent, IngressNetwork>();
+    EXPECT_EQ(status, dispatcher::PostStatus::QueueFull);
+
+    release.set_value();
+    while (executed < 4) {
+        std::this_thread::yield();
+    }
+    status = dispatcher::try_publish<AnotherEvent, IngressNetwork>();
+    EXPECT_EQ(status, dispatcher::PostStatus::Posted);
+    published.get_future().wait();
+    EXPECT_EQ(executed, 4);
+}
+
+struct OrderedIngressNetwork {
+    static constexpr std::size_t ingress_queue_capacity = 4;
+};
+
+TEST_F(ExampleTest, IngressQueueOverflowKeepsPostsInOrder)
+{
+    std::promise<void> started;
+    std::promise<void> release;
+    auto release_future = release.get_future().share();
+    dispatcher::post<OrderedIngressNetwork>([&started, release_future] {
+        started.set_value();
+        release_future.wait();
+    });
+    started.get_future().wait();
+
+    // Beyond the capacity of the queue
+    std::vector<int> order;
+    for (int i = 0; i < 9; i++) {
+        dispatcher::post<OrderedIngressNetwork>([&order, i] { order.push_back(i); });
+    }
+    EXPECT_EQ(dispatcher::try_post<OrderedIngressNetwork>([] {}), dispatcher::PostStatus::QueueFull);
+
+    std::promise<void> done;
+    dispatcher::post<OrderedIngressNetwork>([&order, &done] {
+        order.push_back(9);
+        done.set_value();
+    });
+    release.set_value();
+    done.get_future().wait();
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST_F(ExampleTest, OversizedIngressTasksDoNotCompile)
+{
+    std::array<char, 128> large{};
+    auto oversized = [large] { return large[0]; };
+    auto small = [] {};
+    static_assert(!dispatcher::internal::fits_ingress_queue<OrderedIngressNetwork, decltype(oversized)>::value);
+    static_assert(dispatcher::internal::fits_ingress_queue<OrderedIngressNetwork, decltype(small)>::value);
+    // Without ingress queue, any task can be posted
+    static_assert(dispatcher::internal::fits_ingress_queue<CallNetwork, decltype(oversized)>::value);
+}
+
+struct InlineNetwork {};
+
+struct NonSuspendingEvent {
+    using parameters_t = std::tuple<int>;
+    static constexpr bool non_suspending = true;
+};
+
+bool RunsOnMainFiber()
+{
+    return boost::fibers::context::active()->is_context(boost::fibers::type::main_context);
+}
+
+TEST_F(ExampleTest, NonSuspendingTasksRunWithoutFiber)
+{
+    std::promise<bool> posted_inline;
+    dispatcher::post_inline<InlineNetwork>([&posted_inline] { posted_inline.set_value(RunsOnMainFiber()); });
+    EXPECT_TRUE(posted_inline.get_future().get());
+
+    std::promise<bool> published_inline;
+    auto connection = dispatcher::subscribe<NonSuspendingEvent, InlineNetwork>(
+        [&published_inline](int) { published_inline.set_value(RunsOnMainFiber()); });
+    dispatcher::publish<NonSuspendingEvent, InlineNetwork>(1);
+    EXPECT_TRUE(published_inline.get_future().get());
+
+    std::promise<bool> posted;
+    dispatcher::post<InlineNetwork>([&posted] { posted.set_value(RunsOnMainFiber()); });
+    EXPECT_FALSE(posted.get_future().get());
+}
+
+TEST(StackCacheTest, TrimsDepotToLowWatermark)
+{
+    dispatcher::internal::StackCache cache{1024, 2, 4};
+    EXPECT_EQ(cache.GetStats().blocks_held, 2);
+    EXPECT_EQ(cache.GetStats().bytes_held, 2 * cache.GetStackSize());
+
+    cache.AttachThread();
+    std::vector<void *> blocks;
+    for (int i = 0; i < 10; i++) {
+        blocks.push_back(cache.Allocate());
+    }
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.hits, 2);
+    EXPECT_EQ(stats.misses, 8);
+    EXPECT_EQ(stats.blocks_held, 0);
+
+    // The magazine of the thread keeps the stacks until the thread is detached
+    for (auto block : blocks) {
+        cache.Free(block);
+    }
+    EXPECT_EQ(cache.GetStats().blocks_held, 10);
+    cache.DetachThread();
+    EXPECT_EQ(cache.GetStats().blocks_held, 2);
+}
+
+struct StackCacheNetwork {
+    static constexpr std::size_t stack_cache_low_watermark = 4;
+};
+
+TEST_F(ExampleTest, StackCacheIsPreallocated)
+{
+    auto stats = dispatcher::get_stack_cache_stats<StackCacheNetwork>();
+    EXPECT_EQ(stats.blocks_held, 4);
+    EXPECT_EQ(stats.misses, 0);
+
+    std::promise<void> done;
+    dispatcher::post<StackCacheNetwork>([&done] { done.set_value(); });
+    done.get_future().wait();
+    stats = dispatcher::get_stack_cache_stats<StackCacheNetwork>();
+    EXPECT_GE(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 0);
+}
+
+struct StackArenaNetwork {
+    static constexpr std::size_t stack_arena_size = 3 * 1024 * 1024;
+};
+
+TEST_F(ExampleTest, StacksAreCarvedFromArena)
+{
+    auto stats = dispatcher::get_stack_cache_stats<StackArenaNetwork>();
+    EXPECT_EQ(stats.arena_bytes, 4 * 1024 * 1024);
+
+    std::promise<void> done;
+    dispatcher::post<StackArenaNetwork>([&done] { done.set_value(); });
+    done.get_future().wait();
+}
+
+// Touch the stack from its top down, so that an overflow hits the guard page first. The lowest byte is read back so
+// that the buffer is used.
+template <std::size_t Size>
+char UseStack()
+{
+    volatile char buffer[Size];
+    for (std::size_t i = Size; i > 0; i--) {
+        buffer[i - 1] = 0;
+    }
+    return buffer[0];
+}
+
+struct SmallStackNetwork {
+    static constexpr std::size_t stack_size = 16 * 1024;
+};
+
+struct DeepEvent {
+    using parameters_t = std::tuple<>;
+    static constexpr std::size_t stack_size = 256 * 1024;
+};
+
+TEST_F(ExampleTest, SignatureOverridesStackSize)
+{
+    std::promise<void> done;
+    auto connection = dispatcher::subscribe<DeepEvent, SmallStackNetwork>([&done] {
+        UseStack<128 * 1024>();
+        done.set_value();
+    });
+    dispatcher::publish<DeepEvent, SmallStackNetwork>();
+    done.get_future().wait();
+}
+
+TEST_F(ExampleTest, StackOverflowHitsGuardPage)
+{
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_DEATH(
+        {
+            dispatcher::post<SmallStackNetwork>([] { UseStack<64 * 1024>(); });
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        },
+        "");
+}
+
+struct ProfiledNetwork {
+    static constexpr bool profile_stack_usage = true;
+};
+
+struct DeepProfiledEvent {
+    using parameters_t = std::tuple<>;
+};
+
+struct ShallowProfiledEvent {
+    using parameters_t = std::tuple<>;
+};
+
+TEST_F(ExampleTest, StackUsageIsProfiledPerSignature)
+{
+    std::atomic<int> received{0};
+    auto deep = dispatcher::subscribe<DeepProfiledEvent, ProfiledNetwork>([&received] {
+        UseStack<8 * 1024>();
+        received++;
+    });
+    auto shallow = dispatcher::subscribe<ShallowProfiledEvent, ProfiledNetwork>([&received] { received++; });
+    dispatcher::publish<DeepProfiledEvent, ProfiledNetwork>();
+    dispatcher::publish<ShallowProfiledEvent, ProfiledNetwork>();
+    // Tasks are measured once their fiber released its stack
+    auto profile = dispatcher::get_stack_profile<ProfiledNetwork>();
+    for (int i = 0; i < 100 && profile.signatures.size() < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        profile = dispatcher::get_stack_profile<ProfiledNetwork>();
+    }
+    EXPECT_EQ(received, 2);
+
+    auto deep_usage = profile.signatures.at(typeid(DeepProfiledEvent).name());
+    EXPECT_EQ(deep_usage.samples, 1);
+    EXPECT_GE(deep_usage.high_water_mark, 8 * 1024);
+    EXPECT_LT(deep_usage.high_water_mark, deep_usage.stack_size);
+    auto shallow_usage = profile.signatures.at(typeid(ShallowProfiledEvent).name());
+    EXPECT_LT(shallow_usage.high_water_mark, 8 * 1024);
+    EXPECT_GE(profile.network.samples, 2);
+    EXPECT_GE(profile.network.high_water_mark, deep_usage.high_water_mark);
+}
+
+struct PriorityNetwork {
+    static constexpr std::size_t priority_starvation_limit = 4;
+    static constexpr bool measure_queue_latency = true;
+};
+
+struct UrgentEvent {
+    using parameters_t = std::tuple<>;
+    static constexpr dispatcher::Priority priority = dispatcher::Priority::High;
+};
+
+TEST_F(ExampleTest, HigherPriorityTasksRunFirst)
+{
+    // Every task is pending when the event loop resumes
+    BlockEventLoop<PriorityNetwork>();
+
+    std::string order;
+    std::promise<void> done;
+    auto record = [&order, &done](char task) {
+        order += task;
+        if (order.size() == 7) {
+            done.set_value();
+        }
+    };
+    auto connection = dispatcher::subscribe<UrgentEvent, PriorityNetwork>([&record] { record('H'); });
+    auto low_posted_at = std::chrono::steady_clock::now();
+    dispatcher::post<dispatcher::Priority::Low, PriorityNetwork>([&record] { record('L'); });
+    for (int i = 0; i < 3; i++) {
+        dispatcher::post<dispatcher::Priority::High, PriorityNetwork>([&record] { record('H'); });
+        dispatcher::publish<UrgentEvent, PriorityNetwork>();
+    }
+    auto released_at = std::chrono::steady_clock::now();
+    ReleaseEventLoop();
+    done.get_future().wait();
+
+    // The low priority task is run once it has been passed over priority_starvation_limit times
+    EXPECT_EQ(order, "HHHHLHH");
+    auto stats = dispatcher::get_queue_latency_stats<PriorityNetwork>();
+    EXPECT_EQ(stats[dispatcher::Priority::High].samples, 6);
+    EXPECT_EQ(stats[dispatcher::Priority::Low].samples, 1);
+    EXPECT_GE(stats[dispatcher::Priority::Low].max, released_at - low_posted_at);
+}
+
+struct BoundedNetwork {
+    static constexpr std::size_t event_queue_bound = 2;
+    static constexpr dispatcher::OverflowPolicy overflow_policy = dispatcher::OverflowPolicy::DropNewest;
+};
+
+struct NewestDroppedEvent {
+    using parameters_t = std::tuple<int>;
+};
+
+struct OldestDroppedEvent {
+    using parameters_t = std::tuple<int>;
+    static constexpr dispatcher::OverflowPolicy overflow_policy = dispatcher::OverflowPolicy::DropOldest;
+};
+
+struct FailingEvent {
+    using parameters_t = std::tuple<int>;
+    static constexpr std::size_t event_queue_bound = 1;
+    static constexpr dispatcher::OverflowPolicy overflow_policy = dispatcher::OverflowPolicy::Fail;
+};
+
+struct BlockingEvent {
+    using parameters_t = std::tuple<int>;
+    static constexpr std::size_t event_queue_bound = 1;
+    static constexpr dispatcher::OverflowPolicy overflow_policy = dispatcher::OverflowPolicy::Block;
+};
+
+struct InlineBlockingEvent {
+    using parameters_t = std::tuple<int>;
+    static constexpr std::size_t event_queue_bound = 1;
+    static constexpr dispatcher::OverflowPolicy overflow_policy = dispatcher::OverflowPolicy::Block;
+};
+
+TEST_F(ExampleTest, BoundedEventQueuesApplyTheirPolicy)
+{
+    // The published events stay queued
+    BlockEventLoop<BoundedNetwork>();
+
+    std::vector<int> received;
+    std::promise<void> done;
+    auto record = [&received, &done](int value) {
+        received.push_back(value);
+        if (received.size() == 7) {
+            done.set_value();
+        }
+    };
+    auto newest = dispatcher::subscribe<NewestDroppedEvent, BoundedNetwork>(record);
+    auto oldest = dispatcher::subscribe<OldestDroppedEvent, BoundedNetwork>(record);
+    auto failing = dispatcher::subscribe<FailingEvent, BoundedNetwork>(record);
+    auto blocking = dispatcher::subscribe<BlockingEvent, BoundedNetwork>(record);
+    for (int i = 1; i <= 4; i++) {
+        dispatcher::publish<NewestDroppedEvent, BoundedNetwork>(i);
+    }
+    for (int i = 11; i <= 14; i++) {
+        dispatcher::publish<OldestDroppedEvent, BoundedNetwork>(i);
+    }
+    dispatcher::publish<FailingEvent, BoundedNetwork>(21);
+    EXPECT_THROW((dispatcher::publish<FailingEvent, BoundedNetwork>(22)), dispatcher::EventQueueFull<FailingEvent>);
+    EXPECT_EQ((dispatcher::try_publish<FailingEvent, BoundedNetwork>(23)), dispatcher::PostStatus::QueueFull);
+    dispatcher::publish<BlockingEvent, BoundedNetwork>(31);
+    EXPECT_EQ((dispatcher::try_publish<BlockingEvent, BoundedNetwork>(32)), dispatcher::PostStatus::QueueFull);
+    std::atomic<bool> published{false};
+    std::thread publisher{[&published] {
+        dispatcher::publish<BlockingEvent, BoundedNetwork>(33);
+        published = true;
+    }};
+    // Held back as long as the event loop does not drain the queue
+    while (dispatcher::get_event_queue_stats<BlockingEvent, BoundedNetwork>().blocked_publishers == 0) {
+        std::this_thread::yield();
+    }
+    EXPECT_FALSE(published);
+
+    ReleaseEventLoop();
+    publisher.join();
+    done.get_future().wait();
+    std::sort(received.begin(), received.end());
+    EXPECT_EQ(received, (std::vector<int>{1, 2, 13, 14, 21, 31, 33}));
+
+    auto newest_stats = dispatcher::get_event_queue_stats<NewestDroppedEvent, BoundedNetwork>();
+    EXPECT_EQ(newest_stats.dropped, 2);
+    EXPECT_EQ(newest_stats.high_water_depth, 2);
+    EXPECT_EQ(newest_stats.depth, 0);
+    EXPECT_EQ((dispatcher::get_event_queue_stats<OldestDroppedEvent, BoundedNetwork>().dropped), 2);
+    EXPECT_EQ((dispatcher::get_event_queue_stats<FailingEvent, BoundedNetwork>().rejected), 2);
+    EXPECT_EQ((dispatcher::get_event_queue_stats<BlockingEvent, BoundedNetwork>().rejected), 1);
+
+    // A non-suspending task cannot be blocked, it is handed the full queue back instead
+    std::promise<void> delivered;
+    auto inline_blocking =
+        dispatcher::subscribe<InlineBlockingEvent, BoundedNetwork>([&delivered](int) { delivered.set_value(); });
+    std::promise<bool> rejected;
+    dispatcher::post_inline<BoundedNetwork>([&rejected] {
+        dispatcher::publish<InlineBlockingEvent, BoundedNetwork>(41);
+        try {
+            dispatcher::publish<InlineBlockingEvent, BoundedNetwork>(42);
+            rejected.set_value(false);
+        } catch (const dispatcher::EventQueueFull<InlineBlockingEvent> &) {
+            rejected.set_value(true);
+        }
+    });
+    EXPECT_TRUE(rejected.get_future().get());
+    delivered.get_future().wait();
+    EXPECT_EQ((dispatcher::get_event_queue_stats<InlineBlockingEvent, BoundedNetwork>().rejected), 1);
+}
+
+struct SpeedEvent {
+    using parameters_t = std::tuple<int, const std::string &>;
+    static constexpr bool conflate = true;
+};
+
+struct ConflatingNetwork {};
+
+TEST_F(ExampleTest, ConflatingEventsDeliverTheLatestValueOnce)
+{
+    EXPECT_FALSE((dispatcher::get_latest<SpeedEvent, ConflatingNetwork>()));
+
+    // The published values are conflated
+    BlockEventLoop<ConflatingNetwork>();
+
+    std::vector<int> received;
+    std::promise<void> done;
+    auto connection = dispatcher::subscribe<SpeedEvent, ConflatingNetwork>(
+        [&received, &done](int speed, const std::string &unit) {
+            EXPECT_EQ(unit, "km/h");
+            received.push_back(speed);
+            done.set_value();
+        });
+    for (int speed = 1; speed <= 100; speed++) {
+        dispatcher::publish<SpeedEvent, ConflatingNetwork>(speed, std::string{"km/h"});
+    }
+    EXPECT_EQ((dispatcher::get_latest<SpeedEvent, ConflatingNetwork>()), std::make_tuple(100, std::string{"km/h"}));
+
+    ReleaseEventLoop();
+    // A single token was posted, nothing is delivered after it
+    done.get_future().wait();
+    EXPECT_EQ(received, std::vector<int>{100});
+    auto stats = dispatcher::get_event_queue_stats<SpeedEvent, ConflatingNetwork>();
+    EXPECT_EQ(stats.dropped, 99);
+    EXPECT_EQ(stats.high_water_depth, 1);
+    EXPECT_EQ(stats.depth, 0);
+}
+
+struct PositionEvent {
+    using parameters_t = std::tuple<int, double>;
+    static constexpr bool conflate = true;
+};
+
+TEST_F(ExampleTest, ConflatingEventsAreReadWithoutTearing)
+{
+    // The published values are conflated
+    BlockEventLoop<ConflatingNetwork>();
+
+    std::atomic<int> deliveries{0};
+    std::promise<std::tuple<int, double>> delivered;
+    auto connection = dispatcher::subscribe<PositionEvent, ConflatingNetwork>(
+        [&deliveries, &delivered](int index, double position) {
+            if (deliveries++ == 0) {
+                delivered.set_value({index, position});
+            }
+        });
+    std::atomic<bool> publishing{true};
+    std::thread reader{[&publishing] {
+        while (publishing) {
+            if (auto latest = dispatcher::get_latest<PositionEvent, ConflatingNetwork>()) {
+                auto [index, position] = *latest;
+                EXPECT_EQ(position, index * 0.5);
+            }
+        }
+    }};
+    for (int index = 1; index <= 10000; index++) {
+        dispatcher::publish<PositionEvent, ConflatingNetwork>(index, index * 0.5);
+    }
+    publishing = false;
+    reader.join();
+
+    ReleaseEventLoop();
+    EXPECT_EQ(delivered.get_future().get(), std::make_tuple(10000, 5000.0));
+    auto stats = dispatcher::get_event_queue_stats<PositionEvent, ConflatingNetwork>();
+    EXPECT_EQ(stats.dropped, 9999);
+    EXPECT_EQ(stats.high_water_depth, 1);
+    EXPECT_EQ(stats.depth, 0);
+    EXPECT_EQ(deliveries, 1);
+}
+
+struct StaleCallNetwork {};
+
+TEST_F(ExampleTest, StaleAndCancelledCallsAreDropped)
+{
+    int calls = 0;
+    dispatcher::attach<MaybeAttached>([&calls](int value) {
+        ++calls;
+        return value * 2;
+    });
+    // The calls are still queued when the deadline passes
+    BlockEventLoop<StaleCallNetwork>();
+
+    auto now = std::chrono::steady_clock::now();
+    auto deadline = now + std::chrono::milliseconds(5);
+    dispatcher::CancellationToken token;
+    auto expired =
+        dispatcher::async_call<MaybeAttached, StaleCallNetwork>(dispatcher::CallOptions{deadline, std::nullopt}, 1);
+    auto cancelled =
+        dispatcher::async_call<MaybeAttached, StaleCallNetwork>(dispatcher::CallOptions{std::nullopt, token}, 2);
+    auto reported =
+        dispatcher::try_async_call<MaybeAttached, StaleCallNetwork>(dispatcher::CallOptions{std::nullopt, token}, 3);
+    dispatcher::CallOptions in_time{now + std::chrono::seconds(10), dispatcher::CancellationToken{}};
+    auto completed = dispatcher::async_call<MaybeAttached, StaleCallNetwork>(in_time, 4);
+    token.cancel();
+    std::this_thread::sleep_until(deadline);
+    ReleaseEventLoop();
+
+    EXPECT_THROW(expired.get(), dispatcher::DeadlineExceeded<MaybeAttached>);
+    EXPECT_THROW(cancelled.get(), dispatcher::Cancelled<MaybeAttached>);
+    EXPECT_EQ(reported.get().error(), dispatcher::CallError::Cancelled);
+    EXPECT_EQ(completed.get(), 8);
+    EXPECT_EQ(calls, 1);
+    auto stats = dispatcher::get_dropped_call_stats<StaleCallNetwork>();
+    EXPECT_EQ(stats.deadline_exceeded, 1);
+    EXPECT_EQ(stats.cancelled, 2);
+    dispatcher::detach<MaybeAttached>();
+}
+
+struct ContinuationNetwork {};
+
+TEST_F(ExampleTest, ContinuationsChainCallsWithoutWaiting)
+{
+    dispatcher::attach<MaybeAttached>([](int value) { return value * 2; });
+    int calls = 0;
+    dispatcher::attach<MaybeAttachedVoid>([&calls] { ++calls; });
+
+    std::promise<std::thread::id> loop_thread;
+    dispatcher::post<ContinuationNetwork>([&loop_thread] { loop_thread.set_value(std::this_thread::get_id()); });
+    std::thread::id continuation_thread;
+    auto flow = dispatcher::async_call<MaybeAttached, CallNetwork>(1)
+                    .then<CallNetwork>([](int value) {
+                        return dispatcher::async_call<MaybeAttached, CallNetwork>(value + 1);
+                    })
+                    .then<ContinuationNetwork>([&continuation_thread](int value) {
+                        continuation_thread = std::this_thread::get_id();
+                        return std::to_string(value);
+                    });
+    EXPECT_EQ(flow.get(), "6");
+    EXPECT_EQ(continuation_thread, loop_thread.get_future().get());
+
+    auto failed = dispatcher::async_call<MaybeAttached, CallNetwork>(1)
+                      .then<CallNetwork>([](int) -> int { throw std::runtime_error{"failed"}; })
+                      .then<CallNetwork>([](int value) { return value; });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+
+    auto all = dispatcher::when_all(dispatcher::async_call<MaybeAttached, CallNetwork>(2),
+                                    dispatcher::async_call<MaybeAttachedVoid, CallNetwork>());
+    EXPECT_EQ(std::get<0>(all.get()), 4);
+    EXPECT_EQ(calls, 1);
+
+    std::vector<dispatcher::Future<int>> futures;
+    for (int i = 0; i < 3; i++) {
+        futures.push_back(dispatcher::async_call<MaybeAttached, CallNetwork>(i));
+    }
+    EXPECT_EQ(dispatcher::when_all(std::move(futures)).get(), (std::vector<int>{0, 2, 4}));
+
+    futures.clear();
+    futures.push_back(dispatcher::async_call<MaybeAttached, CallNetwork>(5));
+    auto first = dispatcher::when_any(std::move(futures)).get();
+    EXPECT_EQ(first.index, 0);
+    EXPECT_EQ(first.value, 10);
+    dispatcher::detach<MaybeAttached>();
+    dispatcher::detach<MaybeAttachedVoid>();
+}
+
+struct CoroutineNetwork {};
+
+dispatcher::Coroutine<int> DoubleTwice(int value)
+{
+    int once = co_await dispatcher::async_call<MaybeAttached, CoroutineNetwork>(value);
+    co_return co_await dispatcher::async_call<MaybeAttached, CoroutineNetwork>(once);
+}
+
+dispatcher::Coroutine<std::string> DoubleTwiceAfter(dispatcher::Future<std::nullptr_t> event,
+                                                    dispatcher::Future<void> delay)
+{
+    co_await std::move(event);
+    co_await std::move(delay);
+    co_return std::to_string(co_await DoubleTwice(3));
+}
+
+dispatcher::Coroutine<> FailAfterCall()
+{
+    co_await dispatcher::async_call<MaybeAttached, CoroutineNetwork>(1);
+    throw std::runtime_error{"failed"};
+}
+
+TEST_F(ExampleTest, CoroutinesAwaitCallsEventsAndTimers)
+{
+    DISPATCHER_ENABLE_MANUAL_TIME();
+    dispatcher::attach<MaybeAttached>([](int value) { return value * 2; });
+    dispatcher::Timer<CoroutineNetwork> timer;
+    auto result = dispatcher::spawn<CoroutineNetwork>(
+        DoubleTwiceAfter(dispatcher::expect<AnotherEvent, CoroutineNetwork>(), timer.After(std::chrono::seconds{1})));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(result.wait_for(std::chrono::seconds{0}), boost::fibers::future_status::timeout);
+
+    dispatcher::publish<AnotherEvent, CoroutineNetwork>();
+    DISPATCHER_ADVANCE_TIME(std::chrono::seconds{1});
+    EXPECT_EQ(result.get(), "12");
+    EXPECT_THROW(dispatcher::spawn<CoroutineNetwork>(FailAfterCall()).get(), std::runtime_error);
+    dispatcher::detach<MaybeAttached>();
+}
+
+struct TimerWheelNetwork {};
+
+TEST_F(ExampleTest, TimerWheelCascadesCancelsAndRepeats)
+{
+    DISPATCHER_ENABLE_MANUAL_TIME();
+    std::atomic<int> fired{0};
+    std::atomic<int> repeated{0};
+    std::atomic<int> fast{0};
+    std::array<dispatcher::Timer<TimerWheelNetwork>, 5> timers;
+    timers[0].DoIn(std::chrono::milliseconds{100}, [&] { fired |= 1; });
+    // The scheduled task moves along with its timer
+    std::vector<dispatcher::Timer<TimerWheelNetwork>> moved;
+    moved.push_back(std::move(timers[0]));
+    timers[0].Cancel();
+    // Beyond the first and second wheels, expired once cascaded
+    timers[1].DoIn(std::chrono::seconds{2}, [&] { fired |= 2; });
+    timers[2].DoIn(std::chrono::minutes{5}, [&] { fired |= 4; });
+    timers[3].DoIn(std::chrono::seconds{1}, [&] { fired |= 8; });
+    timers[3].Cancel();
+    auto replaced = timers[4].After(std::chrono::seconds{1});
+    timers[4].DoEvery(std::chrono::milliseconds{300}, [&] { repeated++; });
+    EXPECT_THROW(replaced.get(), boost::system::system_error);
+    // Shorter than a tick, still periodic, and never run concurrently by the worker threads
+    dispatcher::set_worker_threads<TimerWheelNetwork>(2);
+    std::atomic<bool> fast_running{false};
+    moved.emplace_back().DoEvery(std::chrono::microseconds{100}, [&] {
+        EXPECT_FALSE(fast_running.exchange(true));
+        boost::this_fiber::yield();
+        fast++;
+        fast_running = false;
+    });
+
+    DISPATCHER_ADVANCE_TIME(std::chrono::milliseconds{100});
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(fired, 1);
+    EXPECT_EQ(repeated, 0);
+
+    DISPATCHER_ADVANCE_TIME(std::chrono::milliseconds{1900});
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(fired, 3);
+    EXPECT_EQ(repeated, 6);
+    EXPECT_GE(fast, 2);
+
+    timers[4].Cancel();
+    moved.clear();
+    DISPATCHER_ADVANCE_TIME(std::chrono::minutes{5});
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(fired, 7);
+    EXPECT_EQ(repeated, 6);
+}
+
+#ifndef NDEBUG
+struct BlockingInlineNetwork {};
+
+TEST_F(ExampleTest, BlockingNonSuspendingTaskIsDetected)
+{
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_DEATH(
+        {
+            dispatcher::post_inline<BlockingInlineNetwork>([] { boost::this_fiber::yield(); });
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        },
+        "non-suspending task tried to block");
+}
+#endif